@@ -0,0 +1,615 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 8: Encapsulation of the baseband signal into lossless FLAC stream
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define FLAC_BLOCK 4096                    // 每帧采样数
+#define FLAC_BATCH 64                      // 每批并行编码的帧数
+#define FLAC_BITS 16                       // 采样位深
+#define MAX_FIXED_ORDER 4                  // 固定预测器最高阶数
+#define MAX_LPC_ORDER 12                   // LPC 预测器最高阶数
+#define LPC_PRECISION 15                   // LPC 量化系数精度 (位)
+#define MAX_PARTITION_ORDER 8              // Rice 分区最高阶数
+
+// 结构体：按位写入的输出缓冲
+typedef struct {
+    uint8_t *data;            // 已写出的字节
+    size_t size;              // 已写出的字节数
+    size_t capacity;          // 已分配容量
+    uint64_t acc;             // 尚未写出的位
+    int bits;                 // acc 中的位数
+    int failed;               // 扩容失败后为 1，之后的写入全部丢弃
+} Bit_Writer;
+
+// 结构体：一帧待编码的采样与编码结果
+typedef struct {
+    int32_t samples[FLAC_BLOCK];
+    uint32_t count;           // 本帧采样数
+    uint64_t number;          // 帧序号
+    Bit_Writer out;           // 编码后的帧
+} FLAC_Frame;
+
+// 结构体：一个预测器候选的残差与编码参数
+typedef struct {
+    int type;                 // 0 固定预测器，1 LPC
+    int order;                // 阶数
+    int shift;                // LPC 量化移位
+    int32_t coef[MAX_LPC_ORDER];
+    int32_t residual[FLAC_BLOCK];
+    int partition_order;      // Rice 分区阶数
+    int params[1 << MAX_PARTITION_ORDER];
+    uint64_t bits;            // 子帧总位数
+} FLAC_Candidate;
+
+// 结构体：MD5 摘要状态
+typedef struct {
+    uint32_t state[4];
+    uint64_t length;
+    uint8_t buffer[64];
+} MD5_Context;
+
+// 获取外部变量
+extern FILE *file;
+extern uint32_t sample_rate;
+extern int thread_count;
+
+// 定义程序内全局变量
+FLAC_Frame *flac_frames;      // 当前批次的帧
+int flac_pending;             // 当前批次已填满的帧数
+int flac_workers;             // 当前批次的编码线程数
+uint64_t flac_frame_number;   // 下一帧的序号
+uint64_t flac_samples;        // 已编码的采样总数
+uint32_t flac_min_frame;      // 最小帧字节数
+uint32_t flac_max_frame;      // 最大帧字节数
+uint64_t flac_bytes;          // 已写出的帧字节总数
+MD5_Context flac_md5;         // 原始采样的 MD5
+int flac_failed;              // 编码出错后为 1，之后的采样全部拒绝
+
+// 声明程序内函数
+int FLAC_Initialization();
+int FLAC_Process(double *, uint32_t);
+int FLAC_Finalization();
+int FLAC_Encode_Batch();
+void *FLAC_Worker(void *);
+void FLAC_Encode_Frame(FLAC_Frame *);
+void FLAC_Fixed(const int32_t *, uint32_t, FLAC_Candidate *);
+void FLAC_LPC(const int32_t *, uint32_t, int, const double *, FLAC_Candidate *);
+void FLAC_Rice_Search(FLAC_Candidate *, uint32_t);
+void FLAC_Write_Subframe(Bit_Writer *, const int32_t *, uint32_t, FLAC_Candidate *);
+int FLAC_Write_StreamInfo();
+int Bits_Put(Bit_Writer *, uint64_t, int);
+void Bits_Align(Bit_Writer *);
+uint8_t CRC8(const uint8_t *, size_t);
+uint16_t CRC16(const uint8_t *, size_t);
+void MD5_Init(MD5_Context *);
+void MD5_Update(MD5_Context *, const uint8_t *, size_t);
+void MD5_Final(MD5_Context *, uint8_t *);
+
+// 初始化：写入 fLaC 标识与占位的 STREAMINFO，并分配帧批次
+int FLAC_Initialization() {
+    flac_frames = calloc(FLAC_BATCH, sizeof(FLAC_Frame));
+    if (!flac_frames) {
+        printf("FLAC 帧缓冲内存分配失败。\n");
+        return -1;
+    }
+    flac_pending = 0;
+    flac_frame_number = 0;
+    flac_samples = 0;
+    flac_min_frame = UINT32_MAX;
+    flac_max_frame = 0;
+    flac_bytes = 0;
+    flac_failed = 0;
+    MD5_Init(&flac_md5);
+
+    if (FLAC_Write_StreamInfo() != 0) {
+        free(flac_frames);
+        flac_frames = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+// 接收一块归一化音频：量化为 16 位后按帧收集，批次填满时并行编码
+int FLAC_Process(double *audio, uint32_t count) {
+    if (flac_failed) return -1;
+    for (uint32_t i = 0; i < count; i++) {
+        FLAC_Frame *frame = &flac_frames[flac_pending];
+        int32_t value = (short)(32767 * audio[i]);
+        uint8_t bytes[2] = { value & 0xFF, (value >> 8) & 0xFF };
+        MD5_Update(&flac_md5, bytes, 2);
+        frame->samples[frame->count++] = value;
+        if (frame->count == FLAC_BLOCK) {
+            frame->number = flac_frame_number++;
+            if (++flac_pending == FLAC_BATCH && FLAC_Encode_Batch() != 0) return -1;
+        }
+    }
+    flac_samples += count;
+
+    return 0;
+}
+
+// 收尾：编码剩余的不足一帧的采样，回填 STREAMINFO
+int FLAC_Finalization() {
+    if (!flac_failed && flac_frames[flac_pending].count > 0) {
+        flac_frames[flac_pending].number = flac_frame_number++;
+        flac_pending++;
+    }
+    if (!flac_failed && flac_pending > 0) FLAC_Encode_Batch();
+    if (!flac_failed && FLAC_Write_StreamInfo() != 0) flac_failed = 1;
+    for (int f = 0; f < FLAC_BATCH; f++) free(flac_frames[f].out.data);
+    free(flac_frames);
+    flac_frames = NULL;
+    if (flac_failed) return -1;
+
+    printf("FLAC: %llu 个采样，压缩率 %.1f%%\n", (unsigned long long)flac_samples,
+           flac_samples ? 100.0 * flac_bytes / (flac_samples * 2) : 0);
+    return 0;
+}
+
+// 写入 fLaC 标识与 STREAMINFO；收尾时回到文件开头以实际统计值重写
+int FLAC_Write_StreamInfo() {
+    Bit_Writer out = {0};
+    uint8_t digest[16] = {0};
+    int final = flac_frame_number > 0;
+
+    if (final) {
+        MD5_Context context = flac_md5;
+        MD5_Final(&context, digest);
+    }
+
+    Bits_Put(&out, 0x664C6143, 32);                        // "fLaC"
+    Bits_Put(&out, 0x80, 8);                               // 最后一个元数据块，类型 0
+    Bits_Put(&out, 34, 24);
+    Bits_Put(&out, FLAC_BLOCK, 16);
+    Bits_Put(&out, FLAC_BLOCK, 16);
+    Bits_Put(&out, final ? flac_min_frame : 0, 24);
+    Bits_Put(&out, final ? flac_max_frame : 0, 24);
+    Bits_Put(&out, sample_rate, 20);
+    Bits_Put(&out, 1 - 1, 3);
+    Bits_Put(&out, FLAC_BITS - 1, 5);
+    Bits_Put(&out, final ? flac_samples : 0, 36);
+    for (int i = 0; i < 16; i++) Bits_Put(&out, digest[i], 8);
+    if (out.failed) {
+        free(out.data);
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(out.data, 1, out.size, file);
+    fseek(file, 0, SEEK_END);
+    free(out.data);
+
+    return 0;
+}
+
+// 并行编码当前批次的全部帧，并按序号顺序写出
+int FLAC_Encode_Batch() {
+    int threads = thread_count > 0 ? thread_count : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > flac_pending) threads = flac_pending;
+    if (threads < 1) threads = 1;
+
+    // 线程创建失败时该线程负责的帧由调用线程编码
+    pthread_t workers[threads];
+    int started[threads];
+    flac_workers = threads;
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, FLAC_Worker, (void *)(intptr_t)t) == 0;
+    }
+    FLAC_Worker((void *)(intptr_t)0);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(workers[t], NULL);
+        else FLAC_Worker((void *)(intptr_t)t);
+    }
+
+    for (int f = 0; f < flac_pending; f++) {
+        if (flac_frames[f].out.failed) flac_failed = 1;
+    }
+    if (flac_failed) return -1;
+    for (int f = 0; f < flac_pending; f++) {
+        Bit_Writer *out = &flac_frames[f].out;
+        fwrite(out->data, 1, out->size, file);
+        if (out->size < flac_min_frame) flac_min_frame = out->size;
+        if (out->size > flac_max_frame) flac_max_frame = out->size;
+        flac_bytes += out->size;
+        out->size = 0;
+        flac_frames[f].count = 0;
+    }
+    flac_pending = 0;
+
+    return 0;
+}
+
+// 编码线程：第 t 个线程负责批次内序号模线程数等于 t 的帧
+void *FLAC_Worker(void *arg) {
+    int t = (intptr_t)arg;
+    for (int f = t; f < flac_pending; f += flac_workers) {
+        FLAC_Encode_Frame(&flac_frames[f]);
+    }
+
+    return NULL;
+}
+
+// 编码一帧：帧头、单声道子帧、帧尾 CRC
+void FLAC_Encode_Frame(FLAC_Frame *frame) {
+    Bit_Writer *out = &frame->out;
+    uint32_t count = frame->count;
+    out->size = 0;
+    out->bits = 0;
+    out->acc = 0;
+
+    // 帧头：固定块长同步码；非标准块长时以 16 位写出块长减一，采样率取自 STREAMINFO
+    Bits_Put(out, 0xFFF8, 16);
+    Bits_Put(out, count == FLAC_BLOCK ? 12 : 7, 4);
+    Bits_Put(out, 0, 4);
+    Bits_Put(out, 0, 4);
+    Bits_Put(out, 4, 3);
+    Bits_Put(out, 0, 1);
+
+    // 帧序号以 UTF-8 方式编码
+    uint64_t number = frame->number;
+    if (number < 0x80) {
+        Bits_Put(out, number, 8);
+    } else {
+        int length = number < 0x800 ? 2 : number < 0x10000 ? 3 : number < 0x200000 ? 4 : number < 0x4000000 ? 5 : 6;
+        Bits_Put(out, ((0xFF00 >> length) & 0xFF) | (number >> (6 * (length - 1))), 8);
+        for (int i = length - 2; i >= 0; i--) Bits_Put(out, 0x80 | ((number >> (6 * i)) & 0x3F), 8);
+    }
+    if (count != FLAC_BLOCK) Bits_Put(out, count - 1, 16);
+    Bits_Put(out, CRC8(out->data, out->size), 8);
+
+    // 静默或直流段直接以常量子帧编码
+    const int32_t *x = frame->samples;
+    uint32_t same = 1;
+    while (same < count && x[same] == x[0]) same++;
+    if (same == count) {
+        Bits_Put(out, 0, 1);
+        Bits_Put(out, 0, 6);
+        Bits_Put(out, 0, 1);
+        Bits_Put(out, (uint16_t)x[0], FLAC_BITS);
+    } else {
+
+        // 逐一尝试固定预测器与各阶 LPC，保留总位数最少的候选
+        FLAC_Candidate *best = malloc(sizeof(FLAC_Candidate));
+        FLAC_Candidate *trial = malloc(sizeof(FLAC_Candidate));
+        best->bits = UINT64_MAX;
+        for (int order = 0; order <= MAX_FIXED_ORDER && order < (int)count; order++) {
+            trial->order = order;
+            FLAC_Fixed(x, count, trial);
+            if (trial->bits < best->bits) {
+                FLAC_Candidate *swap = best; best = trial; trial = swap;
+            }
+        }
+
+        // LPC：Welch 窗自相关后以 Levinson-Durbin 递推求各阶系数
+        if (count > MAX_LPC_ORDER * 2) {
+            double autoc[MAX_LPC_ORDER + 1] = {0};
+            double *windowed = malloc(count * sizeof(double));
+            for (uint32_t i = 0; i < count; i++) {
+                double w = 2.0 * i / (count - 1) - 1;
+                windowed[i] = x[i] * (1 - w * w);
+            }
+            for (int lag = 0; lag <= MAX_LPC_ORDER; lag++) {
+                for (uint32_t i = lag; i < count; i++) autoc[lag] += windowed[i] * windowed[i - lag];
+            }
+            free(windowed);
+
+            double lpc[MAX_LPC_ORDER][MAX_LPC_ORDER];
+            double error = autoc[0] * (1 + 1e-9);
+            int orders = 0;
+            for (int i = 0; i < MAX_LPC_ORDER && error > 0; i++) {
+                double r = autoc[i + 1];
+                for (int j = 0; j < i; j++) r -= lpc[i - 1][j] * autoc[i - j];
+                r /= error;
+                for (int j = 0; j < i; j++) lpc[i][j] = lpc[i - 1][j] - r * lpc[i - 1][i - 1 - j];
+                lpc[i][i] = r;
+                error *= 1 - r * r;
+                orders = i + 1;
+            }
+            for (int order = 1; order <= orders; order++) {
+                FLAC_LPC(x, count, order, lpc[order - 1], trial);
+                if (trial->bits < best->bits) {
+                    FLAC_Candidate *swap = best; best = trial; trial = swap;
+                }
+            }
+        }
+
+        // 压缩无效时退回原样存储
+        if (best->bits >= 8 + (uint64_t)count * FLAC_BITS) {
+            Bits_Put(out, 0, 1);
+            Bits_Put(out, 1, 6);
+            Bits_Put(out, 0, 1);
+            for (uint32_t i = 0; i < count; i++) Bits_Put(out, (uint16_t)x[i], FLAC_BITS);
+        } else {
+            FLAC_Write_Subframe(out, x, count, best);
+        }
+        free(best);
+        free(trial);
+    }
+
+    // 帧尾：字节对齐后写入整帧的 CRC-16
+    Bits_Align(out);
+    uint16_t crc = CRC16(out->data, out->size);
+    Bits_Put(out, crc, 16);
+}
+
+// 固定预测器：以 0~4 阶差分作为残差
+void FLAC_Fixed(const int32_t *x, uint32_t count, FLAC_Candidate *c) {
+    int order = c->order;
+    c->type = 0;
+    for (uint32_t i = order; i < count; i++) {
+        int64_t r;
+        switch (order) {
+            case 0: r = x[i]; break;
+            case 1: r = (int64_t)x[i] - x[i - 1]; break;
+            case 2: r = (int64_t)x[i] - 2 * (int64_t)x[i - 1] + x[i - 2]; break;
+            case 3: r = (int64_t)x[i] - 3 * (int64_t)x[i - 1] + 3 * (int64_t)x[i - 2] - x[i - 3]; break;
+            default: r = (int64_t)x[i] - 4 * (int64_t)x[i - 1] + 6 * (int64_t)x[i - 2] - 4 * (int64_t)x[i - 3] + x[i - 4]; break;
+        }
+        c->residual[i] = (int32_t)r;
+    }
+    FLAC_Rice_Search(c, count);
+    c->bits += 8 + order * FLAC_BITS;
+}
+
+// LPC 预测器：量化系数后计算残差
+void FLAC_LPC(const int32_t *x, uint32_t count, int order, const double *lpc, FLAC_Candidate *c) {
+    c->type = 1;
+    c->order = order;
+
+    // 量化移位使最大系数恰好占满精度，带误差反馈取整
+    double cmax = 0;
+    for (int j = 0; j < order; j++) if (fabs(lpc[j]) > cmax) cmax = fabs(lpc[j]);
+    if (cmax <= 0) {
+        c->bits = UINT64_MAX;
+        return;
+    }
+    int log2cmax;
+    frexp(cmax, &log2cmax);
+    int shift = LPC_PRECISION - 1 - log2cmax;
+    if (shift > 15) shift = 15;
+    if (shift < 0) {
+        c->bits = UINT64_MAX;
+        return;
+    }
+    c->shift = shift;
+    int32_t qmax = (1 << (LPC_PRECISION - 1)) - 1;
+    double error = 0;
+    for (int j = 0; j < order; j++) {
+        error += lpc[j] * (1 << shift);
+        long q = lround(error);
+        if (q > qmax) q = qmax;
+        if (q < -qmax - 1) q = -qmax - 1;
+        c->coef[j] = (int32_t)q;
+        error -= q;
+    }
+
+    for (uint32_t i = order; i < count; i++) {
+        int64_t sum = 0;
+        for (int j = 0; j < order; j++) sum += (int64_t)c->coef[j] * x[i - 1 - j];
+        int64_t r = x[i] - (sum >> shift);
+        if (r > INT32_MAX / 2 || r < INT32_MIN / 2) {
+            c->bits = UINT64_MAX;
+            return;
+        }
+        c->residual[i] = (int32_t)r;
+    }
+    FLAC_Rice_Search(c, count);
+    c->bits += 8 + order * FLAC_BITS + 4 + 5 + order * LPC_PRECISION;
+}
+
+// 选择 Rice 分区阶数与每个分区的参数，估算残差总位数
+void FLAC_Rice_Search(FLAC_Candidate *c, uint32_t count) {
+    int max_order = 0;
+    while (max_order < MAX_PARTITION_ORDER && count % (2u << max_order) == 0 && (count >> (max_order + 1)) > (uint32_t)c->order) {
+        max_order++;
+    }
+
+    uint64_t best_bits = UINT64_MAX;
+    for (int porder = 0; porder <= max_order; porder++) {
+        int partitions = 1 << porder;
+        uint32_t size = count >> porder;
+        uint64_t bits = 2 + 4;
+        int params[1 << MAX_PARTITION_ORDER];
+        for (int p = 0; p < partitions; p++) {
+            uint32_t start = p == 0 ? (uint32_t)c->order : p * size;
+            uint32_t end = (p + 1) * size;
+            uint64_t sum = 0;
+            for (uint32_t i = start; i < end; i++) {
+                int32_t r = c->residual[i];
+                sum += (uint32_t)(r << 1) ^ (uint32_t)(r >> 31);
+            }
+            uint32_t n = end - start;
+            int k = 0;
+            while (k < 30 && ((uint64_t)n << (k + 1)) < sum) k++;
+            params[p] = k;
+            bits += 5 + (uint64_t)n * (k + 1) + (sum >> k);
+        }
+        if (bits < best_bits) {
+            best_bits = bits;
+            c->partition_order = porder;
+            memcpy(c->params, params, partitions * sizeof(int));
+        }
+    }
+    c->bits = best_bits;
+}
+
+// 写出预测器子帧：预热采样、系数与 Rice 编码的残差
+void FLAC_Write_Subframe(Bit_Writer *out, const int32_t *x, uint32_t count, FLAC_Candidate *c) {
+    Bits_Put(out, 0, 1);
+    Bits_Put(out, c->type == 0 ? 8 | c->order : 32 | (c->order - 1), 6);
+    Bits_Put(out, 0, 1);
+    for (int i = 0; i < c->order; i++) Bits_Put(out, (uint16_t)x[i], FLAC_BITS);
+    if (c->type == 1) {
+        Bits_Put(out, LPC_PRECISION - 1, 4);
+        Bits_Put(out, c->shift, 5);
+        for (int j = 0; j < c->order; j++) Bits_Put(out, (uint32_t)c->coef[j] & ((1u << LPC_PRECISION) - 1), LPC_PRECISION);
+    }
+
+    // 参数超过 14 时使用 5 位参数的 Rice2 编码
+    int partitions = 1 << c->partition_order;
+    int rice2 = 0;
+    for (int p = 0; p < partitions; p++) if (c->params[p] > 14) rice2 = 1;
+    Bits_Put(out, rice2, 2);
+    Bits_Put(out, c->partition_order, 4);
+    uint32_t size = count >> c->partition_order;
+    for (int p = 0; p < partitions; p++) {
+        int k = c->params[p];
+        Bits_Put(out, k, rice2 ? 5 : 4);
+        for (uint32_t i = p == 0 ? (uint32_t)c->order : p * size; i < (uint32_t)(p + 1) * size; i++) {
+            int32_t r = c->residual[i];
+            uint32_t u = (uint32_t)(r << 1) ^ (uint32_t)(r >> 31);
+            uint32_t q = u >> k;
+            while (q >= 32) {
+                Bits_Put(out, 0, 32);
+                q -= 32;
+            }
+            Bits_Put(out, 1, q + 1);
+            if (k) Bits_Put(out, u & ((1u << k) - 1), k);
+        }
+    }
+}
+
+// 写入最多 32 位；扩容失败时记录在 failed 中并返回 -1，由帧或 STREAMINFO 的写出者统一报错退出
+int Bits_Put(Bit_Writer *w, uint64_t value, int bits) {
+    if (w->failed) return -1;
+    if (bits > 32) {
+        if (Bits_Put(w, value >> 32, bits - 32) != 0) return -1;
+        bits = 32;
+    }
+    if (w->size + 8 > w->capacity) {
+        size_t capacity = w->capacity ? w->capacity * 2 : 2 * FLAC_BLOCK * 2 + 64;
+        uint8_t *data = realloc(w->data, capacity);
+        if (!data) {
+            printf("FLAC 输出缓冲内存分配失败。\n");
+            w->failed = 1;
+            return -1;
+        }
+        w->data = data;
+        w->capacity = capacity;
+    }
+    w->acc = (w->acc << bits) | (value & ((1ull << bits) - 1));
+    w->bits += bits;
+    while (w->bits >= 8) {
+        w->bits -= 8;
+        w->data[w->size++] = (w->acc >> w->bits) & 0xFF;
+    }
+
+    return 0;
+}
+
+// 以零位补齐到字节边界
+void Bits_Align(Bit_Writer *w) {
+    if (w->bits) Bits_Put(w, 0, 8 - w->bits);
+}
+
+// CRC-8，多项式 x^8 + x^2 + x + 1
+uint8_t CRC8(const uint8_t *data, size_t size) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+// CRC-16，多项式 x^16 + x^15 + x^2 + 1
+uint16_t CRC16(const uint8_t *data, size_t size) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) crc = crc & 0x8000 ? (crc << 1) ^ 0x8005 : crc << 1;
+    }
+    return crc;
+}
+
+// MD5 (RFC 1321)，用于 STREAMINFO 中原始音频的校验
+static const uint32_t MD5_K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+static const int MD5_R[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static void MD5_Block(MD5_Context *ctx, const uint8_t *block) {
+    uint32_t m[16], a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    for (int i = 0; i < 16; i++) {
+        m[i] = block[4 * i] | (block[4 * i + 1] << 8) | (block[4 * i + 2] << 16) | ((uint32_t)block[4 * i + 3] << 24);
+    }
+    for (int i = 0; i < 64; i++) {
+        uint32_t f;
+        int g;
+        if (i < 16) { f = (b & c) | (~b & d); g = i; }
+        else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) % 16; }
+        else if (i < 48) { f = b ^ c ^ d; g = (3 * i + 5) % 16; }
+        else { f = c ^ (b | ~d); g = (7 * i) % 16; }
+        uint32_t t = d;
+        d = c;
+        c = b;
+        uint32_t x = a + f + MD5_K[i] + m[g];
+        b = b + ((x << MD5_R[i]) | (x >> (32 - MD5_R[i])));
+        a = t;
+    }
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+}
+
+void MD5_Init(MD5_Context *ctx) {
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->length = 0;
+}
+
+void MD5_Update(MD5_Context *ctx, const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        ctx->buffer[ctx->length++ % 64] = data[i];
+        if (ctx->length % 64 == 0) MD5_Block(ctx, ctx->buffer);
+    }
+}
+
+void MD5_Final(MD5_Context *ctx, uint8_t *digest) {
+    uint64_t bits = ctx->length * 8;
+    uint8_t pad = 0x80;
+    MD5_Update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->length % 64 != 56) MD5_Update(ctx, &pad, 1);
+    for (int i = 0; i < 8; i++) {
+        uint8_t byte = (bits >> (8 * i)) & 0xFF;
+        MD5_Update(ctx, &byte, 1);
+    }
+    for (int i = 0; i < 16; i++) digest[i] = (ctx->state[i / 4] >> (8 * (i % 4))) & 0xFF;
+}
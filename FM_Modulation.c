@@ -0,0 +1,153 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 6: Narrowband FM modulation with polyphase upsampling to the SDR rate
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define FM_TAPS 16                         // 多相滤波器每相抽头数
+#define FM_BLOCK 4096                      // 每次写出的复采样块长度，与 IQ_BLOCK 一致
+#define FM_CUTOFF 0.45                     // 插值低通截止频率，相对音频采样率
+
+// 获取外部变量
+extern uint32_t sample_rate;
+
+// 定义程序内全局变量
+double fm_deviation;          // 调频频偏 (Hz)，0 表示不调频
+uint32_t fm_rate;             // 射频采样率，须为音频采样率的整数倍
+int fm_factor;                // 插值倍数
+float *fm_coef;               // 多相滤波器系数，按 [相位][抽头] 排列
+float fm_history[FM_TAPS];    // 最近的音频输入，[0] 为最新
+double fm_phase;              // 调频相位累加器 (弧度)
+double fm_last;               // 最后一个音频输入，用于排空滤波器
+
+// 声明程序内函数
+int FM_Initialization();
+int FM_Process(double *, uint32_t);
+int FM_Flush();
+void FM_Sincos(const float *restrict, float *restrict, uint32_t);
+
+// 初始化调频级：由 Blackman 窗 sinc 原型低通构造多相插值滤波器
+int FM_Initialization() {
+
+    if (fm_rate == 0) fm_rate = sample_rate * 50;
+    if (fm_rate % sample_rate != 0 || fm_rate / sample_rate > FM_BLOCK) {
+        printf("射频采样率 %u Hz 须为音频采样率 %u Hz 的整数倍，可用 --rate 调整音频采样率。\n", fm_rate, sample_rate);
+        return -1;
+    }
+    fm_factor = fm_rate / sample_rate;
+
+    int length = fm_factor * FM_TAPS;
+    free(fm_coef);
+    fm_coef = malloc(length * sizeof(float));
+    if (!fm_coef) {
+        printf("调频滤波器内存分配失败。\n");
+        return -1;
+    }
+
+    // 原型滤波器工作在射频采样率下，截止于音频带宽内，直流增益为插值倍数
+    for (int n = 0; n < length; n++) {
+        double t = n - (length - 1) / 2.0;
+        double x = 2 * FM_CUTOFF * t / fm_factor;
+        double sinc = t == 0 ? 1 : sin(PI * x) / (PI * x);
+        double window = 0.42 - 0.5 * cos(2 * PI * n / (length - 1)) + 0.08 * cos(4 * PI * n / (length - 1));
+        int phase = n % fm_factor, tap = n / fm_factor;
+        fm_coef[phase * FM_TAPS + tap] = (float)(2 * FM_CUTOFF * sinc * window);
+    }
+
+    // 各相位分别归一化，保证直流输入得到恒定频偏
+    for (int p = 0; p < fm_factor; p++) {
+        double sum = 0;
+        for (int t = 0; t < FM_TAPS; t++) sum += fm_coef[p * FM_TAPS + t];
+        for (int t = 0; t < FM_TAPS; t++) fm_coef[p * FM_TAPS + t] /= sum;
+    }
+
+    memset(fm_history, 0, sizeof(fm_history));
+    fm_phase = 0;
+    fm_last = 0;
+
+    return 0;
+}
+
+// 调频处理一块音频：多相插值到射频采样率，累加相位后批量计算 I/Q
+int FM_Process(double *audio, uint32_t count) {
+    float upsampled[FM_BLOCK];
+    float phase[FM_BLOCK];
+    float iq[2 * FM_BLOCK];
+    double scale = 2 * PI * fm_deviation / fm_rate;
+    uint32_t per_block = FM_BLOCK / fm_factor;
+
+    for (uint32_t done = 0; done < count; ) {
+        uint32_t inputs = count - done < per_block ? count - done : per_block;
+        uint32_t outputs = inputs * fm_factor;
+
+        // 多相插值：每个输入采样产生 fm_factor 个输出，每个输出只需一相的 FM_TAPS 次乘加
+        for (uint32_t i = 0; i < inputs; i++) {
+            memmove(fm_history + 1, fm_history, (FM_TAPS - 1) * sizeof(float));
+            fm_history[0] = (float)audio[done + i];
+            const float *restrict history = fm_history;
+            float *restrict out = upsampled + i * fm_factor;
+            for (int p = 0; p < fm_factor; p++) {
+                const float *restrict coef = fm_coef + p * FM_TAPS;
+                float acc = 0;
+                for (int t = 0; t < FM_TAPS; t++) acc += coef[t] * history[t];
+                out[p] = acc;
+            }
+        }
+
+        // 相位累加在双精度下进行并保持在 [-π, π]，再转为单精度交给向量化的正余弦计算
+        // 窄带调频每采样的相位增量远小于 π，一次折回即可
+        double acc = fm_phase;
+        for (uint32_t i = 0; i < outputs; i++) {
+            acc += scale * upsampled[i];
+            if (acc > PI) acc -= 2 * PI;
+            else if (acc < -PI) acc += 2 * PI;
+            phase[i] = (float)acc;
+        }
+        fm_phase = acc;
+
+        FM_Sincos(phase, iq, outputs);
+        IQ_Emit(iq, outputs);
+        done += inputs;
+    }
+    fm_last = audio[count - 1];
+
+    return 0;
+}
+
+// 以最后一个音频输入排空插值滤波器的群延迟
+int FM_Flush() {
+    double tail[FM_TAPS / 2];
+    for (int i = 0; i < FM_TAPS / 2; i++) tail[i] = fm_last;
+
+    return FM_Process(tail, FM_TAPS / 2);
+}
+
+// 批量计算 e^{jθ}，θ ∈ [-π, π]：对半角 θ/2 用泰勒多项式求正余弦，再以倍角公式还原。
+// 无分支、无查表，便于编译器向量化，单精度误差约 1e-7
+void FM_Sincos(const float *restrict phase, float *restrict iq, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float x = 0.5f * phase[i];
+        float x2 = x * x;
+        float s = x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 + x2 * (-1.0f / 39916800))))));
+        float c = 1 + x2 * (-0.5f + x2 * (1.0f / 24 + x2 * (-1.0f / 720 + x2 * (1.0f / 40320 + x2 * (-1.0f / 3628800 + x2 * (1.0f / 479001600))))));
+        iq[2 * i] = c * c - s * s;
+        iq[2 * i + 1] = 2 * s * c;
+    }
+}
@@ -0,0 +1,145 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 5: Encapsulation of the baseband signal into complex I/Q stream
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define IQ_BLOCK 4096                      // 每次写出的复采样块长度
+#define IQ_ANCHOR 64                       // 精确计算相位的间隔，其间以复数旋转插值
+
+// 获取外部变量
+extern FILE *file;
+extern uint32_t sample_rate;
+
+// 定义程序内全局变量
+int iq_format;                // I/Q 输出格式，0 表示输出 WAV
+double iq_offset;             // 复基带频率偏移 (Hz)
+uint64_t iq_samples;          // 已写出的复采样数，用于计算频率偏移的相位
+
+// 声明程序内函数
+int IQ_Write(double, double, uint32_t);
+int IQ_Write_Block(PCM_Block *, double, double);
+int IQ_Emit(float *, uint32_t);
+
+// 生成并写出一个音调的解析信号 e^{j(ωn+φ)}，即音频的上边带复基带形式
+// 每隔 IQ_ANCHOR 个采样精确计算一次相位，其间用单次复数乘法推进，高采样率下也远快于逐点三角函数
+int IQ_Write(double frequency, double phi, uint32_t num_samples) {
+    float buffer[2 * IQ_BLOCK];
+
+    // 静默段不携带载波：开头按 Synth_Fade 由当前相位的单位幅度衰减，之后输出零
+    if (frequency == 0) {
+        double re = cos(phi);
+        double im = sin(phi);
+        for (uint32_t done = 0; done < num_samples; ) {
+            uint32_t count = num_samples - done < IQ_BLOCK ? num_samples - done : IQ_BLOCK;
+            for (uint32_t i = 0; i < count; i++) {
+                double gain = Synth_Fade(done + i);
+                buffer[2 * i] = (float)(re * gain);
+                buffer[2 * i + 1] = (float)(im * gain);
+            }
+            IQ_Emit(buffer, count);
+            done += count;
+        }
+        return 0;
+    }
+
+    double omega = 2 * PI * frequency / sample_rate;
+    double step_re = cos(omega);
+    double step_im = sin(omega);
+
+    for (uint32_t done = 0; done < num_samples; ) {
+        uint32_t count = num_samples - done < IQ_BLOCK ? num_samples - done : IQ_BLOCK;
+        for (uint32_t i = 0; i < count; i += IQ_ANCHOR) {
+            double phase = omega * (done + i) + phi;
+            double re = cos(phase);
+            double im = sin(phase);
+            uint32_t run = count - i < IQ_ANCHOR ? count - i : IQ_ANCHOR;
+            for (uint32_t k = 0; k < run; k++) {
+                buffer[2 * (i + k)] = (float)re;
+                buffer[2 * (i + k) + 1] = (float)im;
+                double next = re * step_re - im * step_im;
+                im = re * step_im + im * step_re;
+                re = next;
+            }
+        }
+        IQ_Emit(buffer, count);
+        done += count;
+    }
+
+    return 0;
+}
+
+// 以当前相位重放缓存块的解析信号：e^{j(θ+φ)} = e^{jθ}·e^{jφ}
+int IQ_Write_Block(PCM_Block *block, double sin_phi, double cos_phi) {
+    float buffer[2 * IQ_BLOCK];
+
+    for (uint32_t done = 0; done < block->num_samples; ) {
+        uint32_t count = block->num_samples - done < IQ_BLOCK ? block->num_samples - done : IQ_BLOCK;
+        for (uint32_t i = 0; i < count; i++) {
+            double c = block->cos_part[done + i];
+            double s = block->sin_part[done + i];
+            buffer[2 * i] = (float)(c * cos_phi - s * sin_phi);
+            buffer[2 * i + 1] = (float)(s * cos_phi + c * sin_phi);
+        }
+        IQ_Emit(buffer, count);
+        done += count;
+    }
+
+    return 0;
+}
+
+// 施加频率偏移并按输出格式写出复采样
+int IQ_Emit(float *iq, uint32_t count) {
+
+    // 频率偏移按绝对采样序号计算相位，与音调切换无关，整段输出连续
+    if (iq_offset != 0) {
+        double omega = 2 * PI * iq_offset / sample_rate;
+        double step_re = cos(omega);
+        double step_im = sin(omega);
+        for (uint32_t i = 0; i < count; i += IQ_ANCHOR) {
+            double phase = 2 * PI * fmod(iq_offset * (double)(iq_samples + i) / sample_rate, 1.0);
+            double re = cos(phase);
+            double im = sin(phase);
+            uint32_t run = count - i < IQ_ANCHOR ? count - i : IQ_ANCHOR;
+            for (uint32_t k = 0; k < run; k++) {
+                float x = iq[2 * (i + k)];
+                float y = iq[2 * (i + k) + 1];
+                iq[2 * (i + k)] = (float)(x * re - y * im);
+                iq[2 * (i + k) + 1] = (float)(x * im + y * re);
+                double next = re * step_re - im * step_im;
+                im = re * step_im + im * step_re;
+                re = next;
+            }
+        }
+    }
+
+    if (iq_format == IQ_CS16) {
+        short buffer[2 * IQ_BLOCK];
+        for (uint32_t i = 0; i < 2 * count; i++) {
+            buffer[i] = (short)(32767 * iq[i]);
+        }
+        fwrite(buffer, sizeof(short), 2 * count, file);
+    } else {
+        fwrite(iq, sizeof(float), 2 * count, file);
+    }
+    iq_samples += count;
+
+    return 0;
+}
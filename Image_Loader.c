@@ -0,0 +1,360 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 10: Image loading with restricted decoders, zero-copy fast paths and YUV input
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+// 默认只编译 PNG、JPEG 与 PNM 解码器；编译时定义 SSTV_STBI_ALL 恢复全部格式，
+// 定义 SSTV_NO_PNG 或 SSTV_NO_JPEG 可进一步裁剪。
+// stb 的 PNM 解码器只用于 16 位 PNM，其格式转换位于 PNG 解码器中，因此裁掉 PNG 时一并裁掉；8 位 PNM 仍走快速路径
+#ifndef SSTV_STBI_ALL
+#define STBI_ONLY_PNM
+#ifndef SSTV_NO_PNG
+#define STBI_ONLY_PNG
+#else
+#define STBI_NO_PNM
+#endif
+#ifndef SSTV_NO_JPEG
+#define STBI_ONLY_JPEG
+#endif
+#endif
+#define STB_IMAGE_IMPLEMENTATION          // stb预处理器
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "header.h"
+#include "stb_image.h"
+
+// 定义程序内全局常量
+#define OWNER_NONE 0                       // 无图像
+#define OWNER_STB 1                        // 像素由 stb 分配
+#define OWNER_FILE 2                       // 像素位于读入的文件缓冲内
+#define OWNER_BORROWED 3                   // 像素由调用者提供，不负责释放
+
+// 获取外部变量
+extern unsigned char *pixels;
+extern int channels;
+extern int height;
+extern int width;
+extern int stride;
+extern int pixel_format;
+extern int mmap_io;
+
+// 定义程序内全局变量
+int pixels_owner;             // 像素内存的归属
+unsigned char *file_buffer;   // 读入的整个图像文件
+size_t file_mapped;           // 图像文件以内存映射读入时的映射长度，0 表示由 malloc 分配
+int raw_width;                // 裸帧宽度，0 表示不是裸帧
+int raw_height;               // 裸帧高度
+int raw_format;               // 裸帧像素格式
+unsigned char *chroma_u;      // YUV 输入的 U(Cb) 分量起点
+unsigned char *chroma_v;      // YUV 输入的 V(Cr) 分量起点
+int chroma_stride;            // 色度每行字节数
+int chroma_step;              // 相邻色度采样的字节间距
+int chroma_vshift;            // 色度垂直抽样，4:2:0 为 1，4:2:2 为 0
+int luma_step;                // 相邻亮度采样的字节间距
+
+// 声明程序内函数
+int Image_Load(char *);
+int Image_From_Buffer(unsigned char *, int, int, int, int);
+int Image_From_Planes(unsigned char *, unsigned char *, unsigned char *, int, int, int, int, int);
+void Image_Free();
+void Image_Release_File();
+int Image_Read_File(char *, size_t *);
+int Image_Parse_PNM(size_t);
+int Pixel_Bytes(int);
+int Pixel_Format(char *);
+void Image_Hash(uint64_t *);
+size_t Frame_Bytes(int, int, int);
+double YUV_Value(char *, int, int);
+double Chroma_Sample(unsigned char *, int, int);
+
+// 加载图像：裸帧与 8 位 PPM/PGM 直接引用文件缓冲，其余格式交给 stb 解码为 RGB
+int Image_Load(char *path) {
+    size_t size;
+
+    if (raw_width > 0) {
+        if (Image_Read_File(path, &size) != 0) return -1;
+        if (size < Frame_Bytes(raw_format, raw_width, raw_height)) {
+            printf("裸帧文件 %s 小于 %dx%d 所需的大小。\n", path, raw_width, raw_height);
+            Image_Free();
+            return -1;
+        }
+        if (Image_From_Buffer(file_buffer, raw_width, raw_height, raw_width * Pixel_Bytes(raw_format), raw_format) != 0) {
+            Image_Free();
+            return -1;
+        }
+        pixels_owner = OWNER_FILE;
+        return 0;
+    }
+
+    // 按文件头识别 P5/P6，可解析时走快速路径
+    if (Image_Read_File(path, &size) != 0) return -1;
+    if (size > 2 && file_buffer[0] == 'P' && (file_buffer[1] == '5' || file_buffer[1] == '6') && Image_Parse_PNM(size) == 0) {
+        return 0;
+    }
+
+    // 通用路径：由内存中的文件解码，避免再经过一次 stdio 读取
+    pixels = stbi_load_from_memory(file_buffer, size, &width, &height, &channels, 3);
+    Image_Release_File();
+    if (!pixels) {
+        printf("图像文件加载失败，请检查图像是否存在。\n");
+        return -1;
+    }
+    stride = width * 3;
+    pixel_format = PIXEL_RGB24;
+    pixels_owner = OWNER_STB;
+
+    return 0;
+}
+
+// 直接引用调用者提供的像素缓冲（例如相机帧），不复制，不负责释放
+// NV12 与 I420 的色度平面须紧随亮度平面之后
+int Image_From_Buffer(unsigned char *buffer, int w, int h, int row_bytes, int format) {
+    if (!buffer || w <= 0 || h <= 0 || row_bytes < w * Pixel_Bytes(format)) {
+        printf("无效的像素缓冲。\n");
+        return -1;
+    }
+    if (format >= PIXEL_NV12 && (w & 1)) {
+        printf("YUV 输入的宽度须为偶数。\n");
+        return -1;
+    }
+    if (format == PIXEL_NV12) {
+        unsigned char *uv = buffer + (size_t)row_bytes * h;
+        return Image_From_Planes(buffer, uv, uv + 1, w, h, row_bytes, row_bytes, format);
+    } else if (format == PIXEL_I420) {
+        unsigned char *u = buffer + (size_t)row_bytes * h;
+        return Image_From_Planes(buffer, u, u + (size_t)(row_bytes / 2) * ((h + 1) / 2), w, h, row_bytes, row_bytes / 2, format);
+    } else if (format == PIXEL_YUYV) {
+        return Image_From_Planes(buffer, buffer + 1, buffer + 3, w, h, row_bytes, row_bytes, format);
+    }
+    pixels = buffer;
+    width = w;
+    height = h;
+    stride = row_bytes;
+    pixel_format = format;
+    channels = format == PIXEL_GRAY8 ? 1 : 3;
+    pixels_owner = OWNER_BORROWED;
+
+    return 0;
+}
+
+// 引用相机输出的 YUV 分量，亮度与色度可位于不同缓冲
+// NV12 的 u、v 分别指向交织色度平面的第 0、1 字节，YUYV 的 u、v 指向帧内第 1、3 字节
+int Image_From_Planes(unsigned char *y, unsigned char *u, unsigned char *v, int w, int h, int y_stride, int c_stride, int format) {
+    if (!y || !u || !v || w <= 0 || h <= 0 || format < PIXEL_NV12) {
+        printf("无效的 YUV 缓冲。\n");
+        return -1;
+    }
+    pixels = y;
+    width = w;
+    height = h;
+    stride = y_stride;
+    pixel_format = format;
+    channels = 3;
+    chroma_u = u;
+    chroma_v = v;
+    chroma_stride = c_stride;
+    chroma_step = format == PIXEL_I420 ? 1 : format == PIXEL_NV12 ? 2 : 4;
+    chroma_vshift = format == PIXEL_YUYV ? 0 : 1;
+    luma_step = format == PIXEL_YUYV ? 2 : 1;
+    pixels_owner = OWNER_BORROWED;
+
+    return 0;
+}
+
+// 释放图像
+void Image_Free() {
+    if (pixels_owner == OWNER_STB) stbi_image_free(pixels);
+    Image_Release_File();
+    pixels = NULL;
+    pixels_owner = OWNER_NONE;
+}
+
+// 释放读入或映射的文件缓冲
+void Image_Release_File() {
+    if (file_mapped) munmap(file_buffer, file_mapped);
+    else free(file_buffer);
+    file_buffer = NULL;
+    file_mapped = 0;
+}
+
+// 一次读入整个文件；内存映射模式下只建立只读映射，不复制
+int Image_Read_File(char *path, size_t *size) {
+    if (mmap_io) {
+        struct stat info;
+        int fd = open(path, O_RDONLY);
+        if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
+            printf("图像文件加载失败，请检查图像是否存在。\n");
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        file_buffer = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (file_buffer == MAP_FAILED) {
+            file_buffer = NULL;
+            printf("图像文件映射失败: %s\n", path);
+            return -1;
+        }
+        madvise(file_buffer, info.st_size, MADV_SEQUENTIAL);
+        file_mapped = info.st_size;
+        *size = info.st_size;
+        return 0;
+    }
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("图像文件加载失败，请检查图像是否存在。\n");
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    file_buffer = length > 0 ? malloc(length) : NULL;
+    if (!file_buffer || fread(file_buffer, 1, length, fp) != (size_t)length) {
+        printf("图像文件读取失败: %s\n", path);
+        free(file_buffer);
+        file_buffer = NULL;
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    *size = length;
+
+    return 0;
+}
+
+// 解析 8 位二进制 PPM/PGM 文件头，像素直接引用文件缓冲；其他位深返回失败交给 stb
+int Image_Parse_PNM(size_t size) {
+    int values[3];
+    size_t pos = 2;
+
+    for (int v = 0; v < 3; v++) {
+        // 跳过空白与注释
+        while (pos < size && (file_buffer[pos] == ' ' || file_buffer[pos] == '\t' || file_buffer[pos] == '\r'
+               || file_buffer[pos] == '\n' || file_buffer[pos] == '#')) {
+            if (file_buffer[pos] == '#') while (pos < size && file_buffer[pos] != '\n') pos++;
+            else pos++;
+        }
+        if (pos >= size || file_buffer[pos] < '0' || file_buffer[pos] > '9') return -1;
+        values[v] = 0;
+        while (pos < size && file_buffer[pos] >= '0' && file_buffer[pos] <= '9') {
+            values[v] = values[v] * 10 + file_buffer[pos++] - '0';
+            if (values[v] > 65535) return -1;
+        }
+    }
+    pos++;
+
+    int format = file_buffer[1] == '6' ? PIXEL_RGB24 : PIXEL_GRAY8;
+    if (values[2] != 255 || values[0] <= 0 || values[1] <= 0
+        || pos + (size_t)values[0] * values[1] * Pixel_Bytes(format) > size) {
+        return -1;
+    }
+    if (Image_From_Buffer(file_buffer + pos, values[0], values[1], values[0] * Pixel_Bytes(format), format) != 0) return -1;
+    pixels_owner = OWNER_FILE;
+
+    return 0;
+}
+
+// 每个像素在首个平面中的字节数
+int Pixel_Bytes(int format) {
+    if (format == PIXEL_RGB24) return 3;
+    if (format == PIXEL_YUYV) return 2;
+    return 1;
+}
+
+// 把已解码图像的尺寸、格式与各平面的像素混入散列；只计每行的有效字节，行尾填充不影响结果
+void Image_Hash(uint64_t *hash) {
+    int header[3] = {width, height, pixel_format};
+    Hash_Update(hash, header, sizeof(header));
+
+    for (int y = 0; y < height; y++) {
+        Hash_Update(hash, pixels + (size_t)y * stride, (size_t)width * Pixel_Bytes(pixel_format));
+    }
+    if (pixel_format == PIXEL_NV12 || pixel_format == PIXEL_I420) {
+        int w = (width + 1) / 2, h = (height + 1) / 2;
+        for (int y = 0; y < h; y++) {
+            if (pixel_format == PIXEL_NV12) {
+                Hash_Update(hash, chroma_u + (size_t)y * chroma_stride, (size_t)w * 2);
+            } else {
+                Hash_Update(hash, chroma_u + (size_t)y * chroma_stride, w);
+                Hash_Update(hash, chroma_v + (size_t)y * chroma_stride, w);
+            }
+        }
+    }
+}
+
+// 由名称查找像素格式，不支持时返回 -1
+int Pixel_Format(char *name) {
+    if (strcmp(name, "rgb24") == 0) return PIXEL_RGB24;
+    if (strcmp(name, "gray8") == 0) return PIXEL_GRAY8;
+    if (strcmp(name, "nv12") == 0) return PIXEL_NV12;
+    if (strcmp(name, "yuyv") == 0) return PIXEL_YUYV;
+    if (strcmp(name, "i420") == 0) return PIXEL_I420;
+    return -1;
+}
+
+// 紧凑排列的一帧所需字节数
+size_t Frame_Bytes(int format, int w, int h) {
+    size_t luma = (size_t)w * h * Pixel_Bytes(format);
+    if (format == PIXEL_NV12 || format == PIXEL_I420) {
+        return luma + (size_t)((w + 1) / 2) * 2 * ((h + 1) / 2);
+    }
+    return luma;
+}
+
+// 由 YUV 输入直接取得各通道强度
+// 相机输出为 BT.601 有限范围，Y 与 Cr、Cb 与 YRYB 模式的取值一致，无需颜色转换
+double YUV_Value(char *channel, int x, int y) {
+    double Y = (double)pixels[(size_t)y * stride + (size_t)x * luma_step];
+
+    if (strcmp(channel, "y") == 0) {
+        return Y;
+    } else if (strcmp(channel, "ry") == 0) {
+        return Chroma_Sample(chroma_v, x, y);
+    } else if (strcmp(channel, "by") == 0) {
+        return Chroma_Sample(chroma_u, x, y);
+    }
+
+    // RGB 模式需反变换，系数为 Channel_Value 中正变换的逆矩阵
+    double Cr = Chroma_Sample(chroma_v, x, y) - 128.0;
+    double Cb = Chroma_Sample(chroma_u, x, y) - 128.0;
+    double L = (Y - 16.0) * 1.164384;
+    double value;
+    if (strcmp(channel, "r") == 0) {
+        value = L + 1.596027 * Cr;
+    } else if (strcmp(channel, "g") == 0) {
+        value = L - 0.391762 * Cb - 0.812968 * Cr;
+    } else {
+        value = L + 2.017232 * Cb;
+    }
+
+    return value < 0.0 ? 0.0 : value > 255.0 ? 255.0 : value;
+}
+
+// 色度重采样：水平方向色度与偶数列亮度共址，奇数列取左右两点均值；
+// 4:2:0 垂直方向两行共用一个色度采样，恰好对应 PD 与 Robot 模式的两行色度均值
+double Chroma_Sample(unsigned char *plane, int x, int y) {
+    unsigned char *row = plane + (size_t)(y >> chroma_vshift) * chroma_stride;
+    int cx = x >> 1;
+
+    if ((x & 1) && cx + 1 < (width + 1) / 2) {
+        return (row[(size_t)cx * chroma_step] + row[(size_t)(cx + 1) * chroma_step]) / 2.0;
+    }
+    return (double)row[(size_t)cx * chroma_step];
+}
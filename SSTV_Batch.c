@@ -0,0 +1,393 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 16: Batch encoding with a work-stealing line-range scheduler
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define BATCH_LINES 8                      // 任务不再拆分的扫描线数
+#define BATCH_BLOCK 4096                   // 交给输出级的采样块长度
+#define BATCH_MEMORY (256ULL << 20)        // 一轮同时合成的作业采样所占内存的上限 (字节)
+
+// 获取外部变量
+extern char *filename;
+extern int sample_format;
+extern int iq_format;
+extern double fm_deviation;
+extern uint64_t planned_samples;
+
+// 结构体：Chase-Lev 工作窃取双端队列，所有者在底部压入与弹出，其他线程从顶部窃取
+// 任务打包为一个 64 位整数：高 32 位为作业序号，其后各 16 位为扫描线区间 [first, last)
+typedef struct {
+    _Atomic int64_t top;      // 窃取端
+    _Atomic int64_t bottom;   // 所有者端
+    _Atomic uint64_t *buffer; // 环形缓冲区
+    int64_t mask;             // 容量减一，容量为 2 的幂
+} Batch_Deque;
+
+// 结构体：一幅图像的编码作业
+typedef struct {
+    SSTV_Index index;         // 音调时序索引
+    double *audio;            // 整个发送内容的采样
+    char output[1024];        // 输出文件名
+} Batch_Job;
+
+// 结构体：一个工作线程的状态与计数
+typedef struct {
+    int id;                   // 线程序号，同时是自己的队列序号
+    double busy;              // 执行任务的时间 (秒)
+    uint64_t tasks;           // 执行的任务数
+    uint64_t steals;          // 成功窃取的次数
+} Batch_Worker;
+
+// 定义程序内全局变量
+Batch_Job *batch_jobs;        // 全部作业
+Batch_Deque *batch_deques;    // 每个线程一个队列
+Batch_Worker *batch_workers;  // 各线程的计数，跨轮累计
+int batch_threads;            // 工作线程数
+double batch_wall;            // 各轮合成的总耗时 (秒)
+_Atomic uint64_t batch_pending; // 尚未完成的扫描线数，归零时各线程退出
+
+// 声明程序内函数
+int Batch(char *, char *);
+int Batch_Prepare(Batch_Job *, char *, char *, char *, int);
+int Batch_Run(int, int);
+void Batch_Report(int);
+void *Batch_Worker_Main(void *);
+void Batch_Execute(Batch_Worker *, uint64_t);
+uint64_t Batch_Boundary(Batch_Job *, size_t);
+int Batch_Write(Batch_Job *);
+int Deque_Init(Batch_Deque *, int64_t);
+int Deque_Push(Batch_Deque *, uint64_t);
+int Deque_Pop(Batch_Deque *, uint64_t *);
+int Deque_Steal(Batch_Deque *, uint64_t *);
+double Batch_Clock();
+
+// 批量编码：列表中每幅图像各自输出一个文件。先逐幅记录音调时序，再把作业按扫描线区间拆成任务，
+// 由工作窃取调度器分给各线程合成，最后按顺序写出。长短作业混合时各线程仍能同时忙到最后。
+// 作业按顺序分轮进行，每轮的采样总量不超过 BATCH_MEMORY（至少一幅），写出后即释放，内存占用与列表长度无关
+int Batch(char *list, char *directory) {
+    char **images, **models;
+
+    if (iq_format) {
+        printf("批量编码仅支持音频输出。\n");
+        return -1;
+    }
+
+    int count = Playlist_Read(list, &images, &models);
+    if (count < 0) return -1;
+
+    batch_threads = Parallel_Threads();
+    batch_jobs = calloc(count, sizeof(Batch_Job));
+    batch_workers = calloc(batch_threads, sizeof(Batch_Worker));
+    if (!batch_jobs || !batch_workers) {
+        printf("批量编码内存分配失败。\n");
+        free(batch_jobs);
+        free(batch_workers);
+        Playlist_Free(images, models, count);
+        return -1;
+    }
+    batch_wall = 0;
+
+    // 图像解码与音调记录依赖全局的图像状态，逐幅串行完成；每幅只记录时序，很快
+    double start = Batch_Clock();
+    int status = 0;
+    for (int i = 0; i < count && status == 0; i++) {
+        status = Batch_Prepare(&batch_jobs[i], images[i], models[i], directory, i);
+    }
+    double prepared = Batch_Clock();
+
+    // 分轮合成与写出：本轮作业的采样空间在合成前分配，写出后释放
+    double rendering = 0, writing = 0;
+    for (int first = 0, last = 0; first < count && status == 0; first = last) {
+        uint64_t bytes = 0;
+        for (last = first; last < count && status == 0; last++) {
+            uint64_t size = batch_jobs[last].index.tones.total_samples * sizeof(double);
+            if (last > first && bytes + size > BATCH_MEMORY) break;
+            batch_jobs[last].audio = malloc(size);
+            if (!batch_jobs[last].audio) {
+                printf("批量编码内存分配失败。\n");
+                status = -1;
+            }
+            bytes += size;
+        }
+
+        double begin = Batch_Clock();
+        if (status == 0) status = Batch_Run(first, last - first);
+        double rendered = Batch_Clock();
+
+        for (int i = first; i < last && status == 0; i++) {
+            printf("写出 %d/%d: %s (%s) -> %s\n", i + 1, count, images[i], models[i], batch_jobs[i].output);
+            status = Batch_Write(&batch_jobs[i]);
+        }
+        for (int i = first; i < last; i++) {
+            free(batch_jobs[i].audio);
+            batch_jobs[i].audio = NULL;
+        }
+        rendering += rendered - begin;
+        writing += Batch_Clock() - rendered;
+    }
+
+    if (status == 0) {
+        Batch_Report(count);
+        printf("准备 %.3f 秒，合成 %.3f 秒，写出 %.3f 秒\n", prepared - start, rendering, writing);
+        printf("End.\n");
+    }
+
+    for (int i = 0; i < count; i++) {
+        Index_Free(&batch_jobs[i].index);
+        free(batch_jobs[i].audio);
+    }
+    free(batch_jobs);
+    free(batch_workers);
+    batch_jobs = NULL;
+    batch_workers = NULL;
+    Playlist_Free(images, models, count);
+
+    return status;
+}
+
+// 为一幅图像建立时序索引，采样空间在所在的一轮开始时分配；输出文件名为 目录/序号_图像主文件名
+int Batch_Prepare(Batch_Job *job, char *image, char *model, char *directory, int number) {
+    char *base = strrchr(image, '/');
+    base = base ? base + 1 : image;
+    char *dot = strrchr(base, '.');
+    int length = dot && dot != base ? (int)(dot - base) : (int)strlen(base);
+    snprintf(job->output, sizeof(job->output), "%s/%03d_%.*s.%s", directory, number + 1, length, base,
+             sample_format == WAV_FLAC ? "flac" : "wav");
+
+    if (Index_Build(&job->index, image, model) != 0) return -1;
+    STATS_ADD(tones, job->index.tones.count);
+
+    return 0;
+}
+
+// 合成一轮作业 [first, first + count)：作业按序号轮流放入各线程的队列，之后由各线程自行拆分与窃取
+int Batch_Run(int first, int count) {
+    batch_deques = calloc(batch_threads, sizeof(Batch_Deque));
+    if (!batch_deques) {
+        printf("批量编码内存分配失败。\n");
+        return -1;
+    }
+
+    // 每个队列最多容纳分给它的整幅作业，加上各自拆分链上未被取走的一半
+    uint64_t pending = 0;
+    for (int k = 0; k < batch_threads; k++) {
+        if (Deque_Init(&batch_deques[k], count / batch_threads + 64) != 0) {
+            for (int j = 0; j < k; j++) free(batch_deques[j].buffer);
+            free(batch_deques);
+            return -1;
+        }
+    }
+    for (int i = first; i < first + count; i++) {
+        uint64_t lines = batch_jobs[i].index.tones.line_count;
+        Deque_Push(&batch_deques[i % batch_threads], (uint64_t)i << 32 | lines);
+        pending += lines;
+    }
+    atomic_store(&batch_pending, pending);
+
+    pthread_t threads[batch_threads];
+    int started[batch_threads];
+
+    // 线程创建失败时其队列无人弹出，由其余线程窃取完成；主线程在全部扫描线完成前不会退出
+    STATS_BEGIN(t);
+    double start = Batch_Clock();
+    int failed = 0;
+    for (int k = 0; k < batch_threads; k++) {
+        batch_workers[k].id = k;
+        started[k] = k > 0 && pthread_create(&threads[k], NULL, Batch_Worker_Main, &batch_workers[k]) == 0;
+        if (k > 0 && !started[k]) failed++;
+    }
+    if (failed) printf("有 %d 个批量编码线程创建失败，其队列由其余线程窃取。\n", failed);
+    Batch_Worker_Main(&batch_workers[0]);
+    for (int k = 1; k < batch_threads; k++) {
+        if (started[k]) pthread_join(threads[k], NULL);
+    }
+    batch_wall += Batch_Clock() - start;
+    STATS_END(STAGE_SYNTH, t);
+
+    for (int k = 0; k < batch_threads; k++) free(batch_deques[k].buffer);
+    free(batch_deques);
+    batch_deques = NULL;
+
+    return 0;
+}
+
+// 报告各轮累计的调度情况：调度效率为各线程执行任务的总时间占 线程数×合成耗时 的比例，其余为空闲
+void Batch_Report(int count) {
+    double busy = 0;
+    uint64_t tasks = 0, steals = 0;
+    for (int k = 0; k < batch_threads; k++) {
+        Batch_Worker *worker = &batch_workers[k];
+        busy += worker->busy;
+        tasks += worker->tasks;
+        steals += worker->steals;
+        printf("线程 %d: 执行 %.3f 秒，任务 %llu 个，窃取 %llu 次\n", k, worker->busy,
+               (unsigned long long)worker->tasks, (unsigned long long)worker->steals);
+    }
+    printf("%d 幅图像，%d 个线程：调度效率 %.1f%%，空闲 %.3f 线程·秒，任务 %llu 个，窃取 %llu 次\n",
+           count, batch_threads, batch_wall > 0 ? 100 * busy / (batch_threads * batch_wall) : 100.0,
+           batch_threads * batch_wall - busy, (unsigned long long)tasks, (unsigned long long)steals);
+}
+
+// 工作线程：先取自己队列底部的任务，队列为空时从其他线程的队列顶部窃取，全部扫描线完成后退出
+void *Batch_Worker_Main(void *arg) {
+    Batch_Worker *worker = arg;
+    uint64_t task;
+
+    while (atomic_load(&batch_pending) > 0) {
+        if (Deque_Pop(&batch_deques[worker->id], &task)) {
+            Batch_Execute(worker, task);
+            continue;
+        }
+        int found = 0;
+        for (int k = 1; k < batch_threads && !found; k++) {
+            found = Deque_Steal(&batch_deques[(worker->id + k) % batch_threads], &task) == 1;
+        }
+        if (found) {
+            worker->steals++;
+            Batch_Execute(worker, task);
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+// 执行一个任务：区间大于 BATCH_LINES 时不断把后一半压回自己的队列供其他线程窃取，只合成剩下的前一段
+void Batch_Execute(Batch_Worker *worker, uint64_t task) {
+    double start = Batch_Clock();
+    Batch_Job *job = &batch_jobs[task >> 32];
+    size_t first = (task >> 16) & 0xFFFF;
+    size_t last = task & 0xFFFF;
+
+    while (last - first > BATCH_LINES) {
+        size_t middle = first + (last - first) / 2;
+        if (!Deque_Push(&batch_deques[worker->id], (task >> 32) << 32 | middle << 16 | last)) break;
+        last = middle;
+    }
+
+    uint64_t a = Batch_Boundary(job, first);
+    uint64_t b = Batch_Boundary(job, last);
+    Index_Render(&job->index, a, b, job->audio + a);
+    atomic_fetch_sub(&batch_pending, last - first);
+
+    worker->busy += Batch_Clock() - start;
+    worker->tasks++;
+}
+
+// 第 line 条扫描线的起始采样；首条扫描线之前的静音与 VIS 归入第一段，最后一条之后的结束段归入最后一段
+uint64_t Batch_Boundary(Batch_Job *job, size_t line) {
+    if (line == 0) return 0;
+    if (line >= job->index.tones.line_count) return job->index.tones.total_samples;
+    return Index_Line_Start(&job->index, line);
+}
+
+// 写出一个作业，结果与 --range 输出整个区间逐位一致
+int Batch_Write(Batch_Job *job) {
+    uint64_t total = job->index.tones.total_samples;
+
+    filename = job->output;
+    planned_samples = total;
+    if (WAV_Open() != 0) return -1;
+    for (uint64_t done = 0; done < total; done += BATCH_BLOCK) {
+        uint32_t count = total - done < BATCH_BLOCK ? total - done : BATCH_BLOCK;
+        if (WAV_Write_Audio(job->audio + done, count) != 0) {
+            WAV_Close();
+            return -1;
+        }
+    }
+    WAV_Close();
+
+    return 0;
+}
+
+// 初始化队列，容量取不小于 capacity 的 2 的幂
+int Deque_Init(Batch_Deque *deque, int64_t capacity) {
+    int64_t size = 16;
+    while (size < capacity) size *= 2;
+    deque->buffer = calloc(size, sizeof(uint64_t));
+    if (!deque->buffer) {
+        printf("批量编码内存分配失败。\n");
+        return -1;
+    }
+    deque->mask = size - 1;
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+
+    return 0;
+}
+
+// 所有者压入任务；队列已满时返回 0，由调用者自行执行
+int Deque_Push(Batch_Deque *deque, uint64_t task) {
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (b - t > deque->mask) return 0;
+
+    atomic_store_explicit(&deque->buffer[b & deque->mask], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+
+    return 1;
+}
+
+// 所有者从底部弹出任务；只剩一个任务时与窃取者竞争顶部
+int Deque_Pop(Batch_Deque *deque, uint64_t *task) {
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return 0;
+    }
+    *task = atomic_load_explicit(&deque->buffer[b & deque->mask], memory_order_relaxed);
+    if (t < b) return 1;
+
+    int won = atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+
+    return won;
+}
+
+// 其他线程从顶部窃取任务；返回 1 为成功，0 为队列为空，-1 为与其他线程竞争失败
+int Deque_Steal(Batch_Deque *deque, uint64_t *task) {
+    int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) return 0;
+
+    uint64_t value = atomic_load_explicit(&deque->buffer[t & deque->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return -1;
+    *task = value;
+
+    return 1;
+}
+
+// 单调时钟 (秒)
+double Batch_Clock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
@@ -0,0 +1,317 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 7: Single-core throughput benchmarks of the synthesis stages
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define BENCH_SECONDS 20                   // 基准测试的信号时长 (秒)
+
+// 获取外部变量
+extern FILE *file;
+extern uint32_t sample_rate;
+extern int iq_format;
+extern double fm_deviation;
+extern uint32_t fm_rate;
+extern int synth_backend;
+extern int sample_format;
+extern uint64_t phase_acc;
+extern uint64_t time_ns;
+extern uint64_t timeline_samples;
+extern uint64_t total_samples;
+extern const SSTV_Mode modes[];
+extern const int mode_count;
+
+// 声明程序内函数
+double Bench_Now();
+int Bench_FM();
+int Bench_FFT();
+int Bench_Synth();
+double Bench_Tones(Tone *, size_t, double *);
+int Bench_Kernels();
+double Bench_Mode(int (*)());
+
+// 基准测试入口
+int Benchmark(char *name) {
+    if (strcmp(name, "fm") == 0) return Bench_FM();
+    if (strcmp(name, "fft") == 0) return Bench_FFT();
+    if (strcmp(name, "synth") == 0) return Bench_Synth();
+    if (strcmp(name, "kernels") == 0) return Bench_Kernels();
+
+    printf("未知的基准测试: %s\n可用: fm, fft, synth, kernels\n", name);
+    return -1;
+}
+
+// 单调时钟 (秒)
+double Bench_Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 调频级：48 kHz 音频经多相插值到 2.4 MS/s 并调频，输出写入 /dev/null
+int Bench_FM() {
+    sample_rate = 48000;
+    fm_rate = 2400000;
+    fm_deviation = 5000;
+    iq_format = IQ_CF32;
+    if (FM_Initialization() != 0) return -1;
+
+    // 测试信号：在 SSTV 频带内扫频的正弦波，生成时间不计入
+    uint32_t count = BENCH_SECONDS * sample_rate;
+    double *audio = malloc(count * sizeof(double));
+    if (!audio) return -1;
+    double phase = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        double frequency = 1500 + 800 * (double)i / count;
+        audio[i] = sin(phase);
+        phase += 2 * PI * frequency / sample_rate;
+    }
+
+    file = fopen("/dev/null", "wb");
+    if (!file) {
+        free(audio);
+        return -1;
+    }
+
+    double start = Bench_Now();
+    for (uint32_t done = 0; done < count; done += 4096) {
+        FM_Process(audio + done, count - done < 4096 ? count - done : 4096);
+    }
+    double elapsed = Bench_Now() - start;
+    fclose(file);
+    free(audio);
+
+    double outputs = (double)count * (fm_rate / sample_rate);
+    printf("FM 调制 (%u Hz -> %u Hz, 频偏 %.0f Hz, 每相 16 抽头):\n", sample_rate, fm_rate, fm_deviation);
+    printf("  耗时 %.3f 秒，输出 %.2f MS/s，%.1f 倍实时\n", elapsed, outputs / elapsed / 1e6, BENCH_SECONDS / elapsed);
+
+    return 0;
+}
+
+// 频谱分析：44.1 kHz 音频的 Welch 功率谱估计，4096 点 FFT，重叠一半
+int Bench_FFT() {
+    uint32_t rate = 44100;
+    uint32_t count = BENCH_SECONDS * rate;
+    double *audio = malloc(count * sizeof(double));
+    if (!audio) return -1;
+    double phase = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        double frequency = 1500 + 800 * (double)i / count;
+        audio[i] = sin(phase);
+        phase += 2 * PI * frequency / rate;
+    }
+
+    Welch_State welch;
+    if (Welch_Init(&welch, 4096) != 0) {
+        free(audio);
+        return -1;
+    }
+    double start = Bench_Now();
+    Welch_Process(&welch, audio, count);
+    double elapsed = Bench_Now() - start;
+
+    printf("Welch 功率谱 (%u Hz, FFT 4096 点, Blackman-Harris 窗, 重叠 50%%):\n", rate);
+    printf("  耗时 %.3f 秒，%llu 段，%.2f MS/s，%.0f 倍实时\n", elapsed, (unsigned long long)welch.segments,
+           count / elapsed / 1e6, BENCH_SECONDS / elapsed);
+    Welch_Free(&welch);
+    free(audio);
+
+    return 0;
+}
+
+// 波形合成：各模式像素时长的随机 8 位取值音调序列，以及同步、VIS 等非像素频率的长音，
+// 比较各合成后端与逐采样 libm sin 的速度与误差
+int Bench_Synth() {
+    static const double pixel_ms[] = {0.19, 0.275, 1.08, 30};
+    static const char *pixel_mode[] = {"PD-120 像素", "Robot-36 像素", "Scottie-DX 像素", "同步与 VIS 长音"};
+    static const double long_tones[] = {1100, 1200, 1300, 1900};
+    static const int backends[] = {SYNTH_LIBM, SYNTH_LUT, SYNTH_ROTATOR};
+    int backend_count = sizeof(backends) / sizeof(backends[0]);
+
+    sample_rate = 44100;
+    uint32_t count = BENCH_SECONDS * sample_rate;
+    size_t capacity = (size_t)(BENCH_SECONDS * 1000 / pixel_ms[0]) + 1;
+    Tone *tones = malloc(capacity * sizeof(Tone));
+    double *reference = malloc(count * sizeof(double));
+    double *audio = malloc(count * sizeof(double));
+    if (!tones || !reference || !audio) {
+        free(tones);
+        free(reference);
+        free(audio);
+        return -1;
+    }
+
+    printf("波形合成 (%u Hz，%d 秒音调序列):\n", sample_rate, BENCH_SECONDS);
+    for (int m = 0; m < 4; m++) {
+        // 音调边界按累计时间取整，与调制时相同；取值由线性同余序列给出，每次运行相同
+        size_t n = 0;
+        uint64_t t_ns = 0, timeline = 0;
+        uint32_t seed = 12345;
+        while (timeline < count && n < capacity) {
+            seed = seed * 1103515245 + 12345;
+            t_ns += Duration_NS(pixel_ms[m]);
+            uint64_t end = Sample_At(t_ns) < count ? Sample_At(t_ns) : count;
+            tones[n].frequency = m == 3 ? long_tones[(seed >> 16) & 3] : 1500 + (double)((seed >> 16) & 0xFF) * COLOR_FREQ_MULT;
+            tones[n].num_samples = end - timeline;
+            timeline = end;
+            n++;
+        }
+
+        printf("  %s %.3f 毫秒 (约 %.1f 采样):\n", pixel_mode[m], pixel_ms[m], (double)count / n);
+        double base = 0;
+        for (int k = 0; k < backend_count; k++) {
+            synth_backend = backends[k];
+            if (Synth_Init() != 0) break;
+            double elapsed = Bench_Tones(tones, n, k == 0 ? reference : audio);
+            if (k == 0) {
+                base = elapsed;
+                printf("    %-8s %6.2f ns/采样  %7.1f MS/s\n", Synth_Name(backends[k]), elapsed / count * 1e9,
+                       count / elapsed / 1e6);
+                continue;
+            }
+
+            // 误差：与 libm 结果的最大差值，以及量化为 16 位后不同的采样数
+            double max_error = 0;
+            uint32_t differ = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                double error = fabs(audio[i] - reference[i]);
+                if (error > max_error) max_error = error;
+                if ((short)(32767 * audio[i]) != (short)(32767 * reference[i])) differ++;
+            }
+            printf("    %-8s %6.2f ns/采样  %7.1f MS/s  加速 %.2f 倍  最大误差 %.2e  16 位采样不同 %u 个\n",
+                   Synth_Name(backends[k]), elapsed / count * 1e9, count / elapsed / 1e6, base / elapsed, max_error,
+                   differ);
+        }
+    }
+    synth_backend = SYNTH_LIBM;
+    Synth_Free();
+    free(tones);
+    free(reference);
+    free(audio);
+
+    return 0;
+}
+
+// 以当前后端生成整个音调序列，相位连续；取三次中最短的耗时
+double Bench_Tones(Tone *tones, size_t n, double *out) {
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        double start = Bench_Now();
+        uint64_t phase = 0;
+        double *p = out;
+        for (size_t k = 0; k < n; k++) {
+            uint64_t step = Synth_Step(tones[k].frequency);
+            Synth_Tone(p, tones[k].frequency, step, phase, 0, tones[k].num_samples);
+            p += tones[k].num_samples;
+            phase += step * tones[k].num_samples;
+        }
+        double elapsed = Bench_Now() - start;
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+
+    return best;
+}
+
+// 专用合成函数：各模式图像部分分别以通用的 Generate_* 与由时序表展开的专用函数生成，
+// 先比较两者记录的音调时序是否逐一相同，再以 16 位 PCM 写出到 /dev/null 计时
+int Bench_Kernels() {
+    static const int backends[] = {SYNTH_LIBM, SYNTH_LUT};
+
+    sample_rate = 44100;
+    sample_format = WAV_PCM16;
+    file = fopen("/dev/null", "wb");
+    if (!file) return -1;
+
+    printf("专用合成函数 (%u Hz，图像部分，输出 16 位 PCM 到 /dev/null):\n", sample_rate);
+    int status = 0;
+    for (int m = 0; m < mode_count && status == 0; m++) {
+        const SSTV_Mode *mode = &modes[m];
+
+        // 测试图像：确定的渐变与纹理
+        int rows = mode->height;
+        unsigned char *image = malloc((size_t)mode->width * rows * 3);
+        if (!image) {
+            status = -1;
+            break;
+        }
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < mode->width; x++) {
+                unsigned char *pixel = image + ((size_t)y * mode->width + x) * 3;
+                pixel[0] = x * 255 / mode->width;
+                pixel[1] = y * 255 / rows;
+                pixel[2] = (x * 7 + y * 13) & 0xFF;
+            }
+        }
+        Image_From_Buffer(image, mode->width, mode->height, mode->width * 3, PIXEL_RGB24);
+
+        for (int k = 0; k < 2 && status == 0; k++) {
+            synth_backend = backends[k];
+            if (Synth_Init() != 0) {
+                status = -1;
+                break;
+            }
+
+            Tone_List generic, kernel;
+            WAV_Capture_Begin(&generic);
+            mode->generate();
+            WAV_Capture_End();
+            WAV_Capture_Begin(&kernel);
+            mode->kernel();
+            WAV_Capture_End();
+            int same = Tone_Same(&generic, &kernel);
+            uint64_t samples = generic.total_samples;
+            Tone_Free(&generic);
+            Tone_Free(&kernel);
+
+            double slow = Bench_Mode(mode->generate);
+            double fast = Bench_Mode(mode->kernel);
+            printf("  %-10s %-7s 通用 %7.1f 毫秒 (%5.2f ns/采样)  专用 %7.1f 毫秒 (%5.2f ns/采样)  加速 %.2f 倍  音调时序%s\n",
+                   mode->name, Synth_Name(backends[k]), slow * 1e3, slow / samples * 1e9, fast * 1e3,
+                   fast / samples * 1e9, slow / fast, same ? "一致" : "不一致");
+            if (!same) status = -1;
+        }
+        Image_Free();
+        free(image);
+    }
+    synth_backend = SYNTH_LIBM;
+    Synth_Free();
+    fclose(file);
+    file = NULL;
+
+    return status;
+}
+
+// 从零时刻、零相位生成一次图像部分，取三次中最短的耗时
+double Bench_Mode(int (*generate)()) {
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        phase_acc = 0;
+        time_ns = 0;
+        timeline_samples = 0;
+        total_samples = 0;
+        double start = Bench_Now();
+        generate();
+        double elapsed = Bench_Now() - start;
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+
+    return best;
+}
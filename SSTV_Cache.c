@@ -0,0 +1,281 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 18: Content-addressed cache of encoded output with LRU eviction
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+#include "header.h"
+
+// 定义程序内全局常量
+#define CACHE_VERSION 1                    // 缓存键格式版本，输出格式变化时递增使旧条目失效
+#define CACHE_KEY 33                       // 键的十六进制字符串长度（含结尾）
+#define CACHE_SIZE_MB 1024                 // 默认的缓存容量上限
+
+// 获取外部变量
+extern char *filename;
+extern uint32_t sample_rate;
+extern int sample_format;
+extern int force_rf64;
+extern int iq_format;
+extern double iq_offset;
+extern double fm_deviation;
+extern uint32_t fm_rate;
+extern int end_tones;
+extern char *fsk_id;
+extern int synth_backend;
+extern uint64_t total_samples;
+extern uint64_t time_ns;
+
+// 结构体：缓存目录中的一个条目
+typedef struct {
+    char name[64];            // 文件名
+    off_t size;               // 字节数
+    double used;              // 最近使用时间（修改时间，秒）
+} Cache_Entry;
+
+// 定义程序内全局变量
+char *cache_dir;              // 缓存目录，为空时不使用缓存
+double cache_size_mb = CACHE_SIZE_MB; // 缓存容量上限 (MB)
+uint64_t cache_hits;          // 命中次数
+uint64_t cache_misses;        // 未命中次数
+uint64_t cache_evictions;     // 淘汰的条目数
+
+// 声明程序内函数
+int Cache_Init();
+void Hash_Init(uint64_t *);
+void Hash_Update(uint64_t *, const void *, size_t);
+int Cache_Key(char *, char *);
+void Cache_Options(uint64_t *, char *);
+int Cache_Path(char *, size_t, char *);
+int Cache_Fetch(char *);
+int Cache_Store(char *);
+int Cache_Copy(char *, char *);
+int Cache_Evict(char *);
+int Cache_Compare(const void *, const void *);
+void Cache_Totals(char *);
+void Cache_Report();
+
+// 检查缓存目录，不存在时创建
+int Cache_Init() {
+    struct stat info;
+    if (stat(cache_dir, &info) == 0 && S_ISDIR(info.st_mode)) return 0;
+    if (mkdir(cache_dir, 0755) != 0) {
+        printf("无法创建缓存目录: %s\n", cache_dir);
+        return -1;
+    }
+
+    return 0;
+}
+
+// 128 位内容散列的初值：两路独立的 64 位乘法-移位混合
+void Hash_Init(uint64_t *hash) {
+    hash[0] = 0x9E3779B97F4A7C15ULL;
+    hash[1] = 0xC2B2AE3D27D4EB4FULL;
+}
+
+// 以 8 字节为单位混入数据，尾部不足 8 字节时补零并混入长度
+void Hash_Update(uint64_t *hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    uint64_t h0 = hash[0], h1 = hash[1];
+
+    for (; size >= 8; bytes += 8, size -= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        h0 = (h0 ^ word) * 0xFF51AFD7ED558CCDULL;
+        h0 ^= h0 >> 32;
+        h1 = (h1 ^ word) * 0xC4CEB9FE1A85EC53ULL;
+        h1 ^= h1 >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes, size);
+    tail ^= (uint64_t)size << 56;
+    h0 = (h0 ^ tail) * 0xFF51AFD7ED558CCDULL;
+    h0 ^= h0 >> 32;
+    h1 = (h1 ^ tail) * 0xC4CEB9FE1A85EC53ULL;
+    h1 ^= h1 >> 29;
+
+    hash[0] = h0;
+    hash[1] = h1;
+}
+
+// 缓存键：已解码像素的散列，加上模式与一切影响输出的选项
+int Cache_Key(char *model, char *key) {
+    uint64_t hash[2];
+
+    Hash_Init(hash);
+    Image_Hash(hash);
+    Cache_Options(hash, model);
+    snprintf(key, CACHE_KEY, "%016llx%016llx", (unsigned long long)hash[0], (unsigned long long)hash[1]);
+
+    return 0;
+}
+
+// 混入模式与一切影响输出的选项；线程数、内存映射等不影响输出的选项不计入
+void Cache_Options(uint64_t *hash, char *model) {
+    char options[512];
+    int length = snprintf(options, sizeof(options), "v%d %s %u %d %d %d %.6f %.6f %u %d %s %s", CACHE_VERSION, model,
+                          sample_rate, sample_format, force_rf64, iq_format, iq_offset, fm_deviation, fm_rate,
+                          end_tones, fsk_id ? fsk_id : "", Synth_Name(synth_backend));
+    Hash_Update(hash, options, length);
+}
+
+// 键对应的缓存文件名
+int Cache_Path(char *path, size_t size, char *key) {
+    return snprintf(path, size, "%s/%s.%s", cache_dir, key,
+                    iq_format ? "iq" : sample_format == WAV_FLAC ? "flac" : "wav") < (int)size ? 0 : -1;
+}
+
+// 查找缓存：命中时把缓存文件复制（或共享数据块）到输出文件，并更新其使用时间；返回 1 表示命中
+int Cache_Fetch(char *key) {
+    char path[1024];
+
+    if (Cache_Path(path, sizeof(path), key) != 0 || access(path, R_OK) != 0) {
+        cache_misses++;
+        return 0;
+    }
+    if (Cache_Copy(path, filename) != 0) {
+        cache_misses++;
+        return 0;
+    }
+    utimensat(AT_FDCWD, path, NULL, 0);
+    cache_hits++;
+    printf("缓存命中: %s\n", key);
+
+    return 1;
+}
+
+// 把刚写出的输出存入缓存：先写入临时文件再改名，其他进程不会读到不完整的条目；之后按容量上限淘汰
+int Cache_Store(char *key) {
+    char path[1024], temp[1024];
+
+    if (Cache_Path(path, sizeof(path), key) != 0) return -1;
+    snprintf(temp, sizeof(temp), "%s/.%s.%d", cache_dir, key, (int)getpid());
+    if (Cache_Copy(filename, temp) != 0 || rename(temp, path) != 0) {
+        unlink(temp);
+        printf("无法写入缓存: %s\n", path);
+        return -1;
+    }
+    printf("已存入缓存: %s\n", key);
+
+    return Cache_Evict(path);
+}
+
+// 复制文件：文件系统支持时以 reflink 共享数据块，否则逐块复制
+int Cache_Copy(char *source, char *target) {
+    int in = open(source, O_RDONLY);
+    if (in < 0) return -1;
+    int out = open(target, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        close(in);
+        return -1;
+    }
+
+    int status = -1;
+#ifdef FICLONE
+    if (ioctl(out, FICLONE, in) == 0) status = 0;
+#endif
+    if (status != 0) {
+        char block[65536];
+        ssize_t count;
+        status = 0;
+        while ((count = read(in, block, sizeof(block))) > 0) {
+            if (write(out, block, count) != count) {
+                status = -1;
+                break;
+            }
+        }
+        if (count < 0) status = -1;
+    }
+
+    close(in);
+    if (close(out) != 0) status = -1;
+
+    return status;
+}
+
+// 按最近使用时间淘汰：总大小超过上限时从最久未用的条目删起，刚存入的条目保留
+int Cache_Evict(char *keep) {
+    DIR *dir = opendir(cache_dir);
+    if (!dir) return -1;
+
+    Cache_Entry *entries = NULL;
+    size_t count = 0, capacity = 0;
+    off_t total = 0;
+    struct dirent *item;
+    char path[1024];
+    while ((item = readdir(dir))) {
+        struct stat info;
+        if (item->d_name[0] == '.' || strlen(item->d_name) >= sizeof(entries[0].name)) continue;
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, item->d_name);
+        if (stat(path, &info) != 0 || !S_ISREG(info.st_mode)) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            Cache_Entry *grown = realloc(entries, capacity * sizeof(Cache_Entry));
+            if (!grown) break;
+            entries = grown;
+        }
+        snprintf(entries[count].name, sizeof(entries[count].name), "%s", item->d_name);
+        entries[count].size = info.st_size;
+        entries[count].used = info.st_mtim.tv_sec + info.st_mtim.tv_nsec * 1e-9;
+        total += info.st_size;
+        count++;
+    }
+    closedir(dir);
+
+    off_t limit = (off_t)(cache_size_mb * 1048576);
+    qsort(entries, count, sizeof(Cache_Entry), Cache_Compare);
+    for (size_t i = 0; i < count && total > limit; i++) {
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, entries[i].name);
+        if (strcmp(path, keep) == 0) continue;
+        if (unlink(path) == 0) {
+            total -= entries[i].size;
+            cache_evictions++;
+        }
+    }
+    free(entries);
+
+    return 0;
+}
+
+// 按使用时间从旧到新排序
+int Cache_Compare(const void *a, const void *b) {
+    double x = ((const Cache_Entry *)a)->used, y = ((const Cache_Entry *)b)->used;
+    return x < y ? -1 : x > y;
+}
+
+// 命中时按规划恢复本应写出的时长与采样数，供守护进程统计与回复
+void Cache_Totals(char *model) {
+    SSTV_Plan plan;
+    Plan_Mode(&plan, model, LEAD_SILENCE_MS * 1000000ULL);
+    time_ns = plan.end_ns + LEAD_SILENCE_MS * 1000000ULL;
+    total_samples = Plan_Total_Samples(&plan) * (fm_deviation > 0 ? fm_rate / sample_rate : 1);
+}
+
+// 打印本次运行的命中统计
+void Cache_Report() {
+    uint64_t lookups = cache_hits + cache_misses;
+    printf("缓存: 命中 %llu 次，未命中 %llu 次，命中率 %.1f%%，淘汰 %llu 个条目\n",
+           (unsigned long long)cache_hits, (unsigned long long)cache_misses,
+           lookups ? 100.0 * cache_hits / lookups : 0.0, (unsigned long long)cache_evictions);
+}
@@ -0,0 +1,441 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 17: Long-running encoder daemon with a Unix socket job queue
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define DAEMON_QUEUE 4                     // 默认的任务队列深度
+#define DAEMON_LINE 2048                   // 请求行的最大长度
+#define DAEMON_MAX_BUFFER (64 << 20)       // 内联像素缓冲的最大字节数
+#define DAEMON_TIMEOUT 5                   // 读取请求的超时 (秒)
+
+// 获取外部变量
+extern char *filename;
+extern uint64_t total_samples;
+extern uint64_t time_ns;
+extern double fm_deviation;
+extern uint64_t cache_hits;
+extern uint64_t cache_misses;
+
+// 结构体：一个编码任务，完成后经同一连接回复
+typedef struct {
+    int fd;                   // 客户端连接
+    char model[64];           // 调制模式
+    char output[1024];        // 输出文件名，"-" 表示经连接传回
+    char image[1024];         // 图像文件名，内联缓冲时为空
+    unsigned char *buffer;    // 内联像素缓冲
+    int width, height;        // 内联缓冲的尺寸
+    int format;               // 内联缓冲的像素格式
+} Daemon_Job;
+
+// 结构体：守护进程的累计计数
+typedef struct {
+    uint64_t accepted;        // 接受的任务数
+    uint64_t done;            // 成功完成的任务数
+    uint64_t failed;          // 失败的任务数
+    uint64_t rejected;        // 队列已满而拒绝的任务数
+    uint64_t samples;         // 写出的采样数
+    double audio;             // 生成的发送时长 (秒)
+    double busy;              // 编码耗时 (秒)
+    int max_depth;            // 出现过的最大队列深度
+    uint64_t cache_hits;      // 输出缓存命中次数
+    uint64_t cache_misses;    // 输出缓存未命中次数
+} Daemon_Stats;
+
+// 定义程序内全局变量
+int queue_depth = DAEMON_QUEUE; // 任务队列深度，队列满时拒绝新任务以形成背压
+Daemon_Job *daemon_queue;     // 环形任务队列
+int daemon_head, daemon_count; // 队首位置与队列中的任务数
+int daemon_running;           // 是否继续接受任务
+int daemon_busy;              // 编码线程是否正在处理任务
+Daemon_Stats daemon_stats;    // 累计计数
+double daemon_start;          // 启动时刻
+pthread_mutex_t daemon_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t daemon_ready = PTHREAD_COND_INITIALIZER;
+volatile sig_atomic_t daemon_signal; // 收到终止信号
+
+// 声明程序内函数
+int Daemon(char *);
+int Daemon_Request(int);
+int Daemon_Submit(Daemon_Job *);
+void *Daemon_Encoder(void *);
+int Daemon_Encode(Daemon_Job *);
+int Daemon_Reply(Daemon_Job *, int, char *);
+int Daemon_Stats_Reply(int);
+int Daemon_Read_Line(int, char *, size_t);
+int Daemon_Read(int, unsigned char *, size_t);
+int Daemon_Send(int, const void *, size_t);
+void Daemon_Signal(int);
+double Daemon_Clock();
+
+// 守护进程：在 Unix 域套接字上接受编码任务，进程与编码器常驻，省去每次启动、动态链接与内存分配的预热，
+// 结束段缓存与调频滤波器等也只在首次使用时建立。请求在主线程读入后放入有界队列，由编码线程依次处理并经原连接回复
+int Daemon(char *path) {
+    struct sockaddr_un address;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("套接字路径过长: %s\n", path);
+        return -1;
+    }
+    if (queue_depth < 1) queue_depth = 1;
+    daemon_queue = calloc(queue_depth, sizeof(Daemon_Job));
+    if (!daemon_queue) {
+        printf("任务队列内存分配失败。\n");
+        return -1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        printf("无法监听套接字 %s: %s\n", path, strerror(errno));
+        if (listener >= 0) close(listener);
+        free(daemon_queue);
+        return -1;
+    }
+
+    // 客户端提前断开时不终止进程；终止信号使 accept 返回，随后处理完队列中的任务再退出
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = Daemon_Signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    daemon_start = Daemon_Clock();
+    daemon_running = 1;
+    pthread_t encoder;
+    pthread_create(&encoder, NULL, Daemon_Encoder, NULL);
+    printf("sstvd 已在 %s 上监听，队列深度 %d\n", path, queue_depth);
+    fflush(stdout);
+
+    while (!daemon_signal) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            printf("接受连接失败: %s\n", strerror(errno));
+            break;
+        }
+        if (Daemon_Request(fd) > 0) break;
+    }
+
+    pthread_mutex_lock(&daemon_lock);
+    daemon_running = 0;
+    pthread_cond_signal(&daemon_ready);
+    pthread_mutex_unlock(&daemon_lock);
+    pthread_join(encoder, NULL);
+
+    close(listener);
+    unlink(path);
+    free(daemon_queue);
+    printf("sstvd 已退出，完成 %llu 个任务。\n", (unsigned long long)daemon_stats.done);
+
+    return 0;
+}
+
+// 读入并分派一个请求；返回 1 表示收到关闭请求
+// ENCODE <模式> <输出> <图像文件名>
+// BUFFER <模式> <输出> <宽>x<高> <像素格式> <字节数>，其后紧跟像素数据
+// STATS | SHUTDOWN
+int Daemon_Request(int fd) {
+    char line[DAEMON_LINE];
+    Daemon_Job job;
+
+    struct timeval timeout = {DAEMON_TIMEOUT, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (Daemon_Read_Line(fd, line, sizeof(line)) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.fd = fd;
+    char format[16];
+    int consumed = 0;
+    size_t bytes = 0;
+
+    if (strcmp(line, "STATS") == 0) {
+        Daemon_Stats_Reply(fd);
+        close(fd);
+        return 0;
+    } else if (strcmp(line, "SHUTDOWN") == 0) {
+        Daemon_Send(fd, "OK\n", 3);
+        close(fd);
+        return 1;
+    } else if (sscanf(line, "ENCODE %63s %1023s %n", job.model, job.output, &consumed) == 2 && consumed > 0 && line[consumed]) {
+        snprintf(job.image, sizeof(job.image), "%s", line + consumed);
+    } else if (sscanf(line, "BUFFER %63s %1023s %dx%d %15s %zu", job.model, job.output, &job.width, &job.height, format, &bytes) == 6) {
+        job.format = Pixel_Format(format);
+        if (job.format < 0 || job.width <= 0 || job.height <= 0 || bytes > DAEMON_MAX_BUFFER ||
+            bytes < Frame_Bytes(job.format, job.width, job.height)) {
+            Daemon_Reply(&job, -1, "像素缓冲的尺寸、格式或长度无效");
+            return 0;
+        }
+        // 模式按固定分辨率读取像素，缓冲小于模式时会越界
+        const SSTV_Mode *mode = Find_Mode(job.model);
+        if (mode && (job.width < mode->width || job.height < mode->height)) {
+            Daemon_Reply(&job, -1, "像素缓冲小于模式的分辨率");
+            return 0;
+        }
+        job.buffer = malloc(bytes);
+        if (!job.buffer || Daemon_Read(fd, job.buffer, bytes) != 0) {
+            free(job.buffer);
+            Daemon_Reply(&job, -1, "像素数据读取失败");
+            return 0;
+        }
+    } else {
+        Daemon_Reply(&job, -1, "无法识别的请求");
+        return 0;
+    }
+
+    if (!Valid_Model(job.model)) {
+        free(job.buffer);
+        Daemon_Reply(&job, -1, "错误的调制模式");
+        return 0;
+    }
+    Daemon_Submit(&job);
+
+    return 0;
+}
+
+// 放入任务队列；队列已满时立即回复 BUSY，由客户端稍后重试
+int Daemon_Submit(Daemon_Job *job) {
+    pthread_mutex_lock(&daemon_lock);
+    if (daemon_count == queue_depth) {
+        daemon_stats.rejected++;
+        pthread_mutex_unlock(&daemon_lock);
+        char reply[64];
+        int length = snprintf(reply, sizeof(reply), "BUSY %d\n", queue_depth);
+        Daemon_Send(job->fd, reply, length);
+        close(job->fd);
+        free(job->buffer);
+        return -1;
+    }
+    daemon_queue[(daemon_head + daemon_count) % queue_depth] = *job;
+    daemon_count++;
+    daemon_stats.accepted++;
+    if (daemon_count > daemon_stats.max_depth) daemon_stats.max_depth = daemon_count;
+    pthread_cond_signal(&daemon_ready);
+    pthread_mutex_unlock(&daemon_lock);
+
+    return 0;
+}
+
+// 编码线程：编码器依赖全局状态，所有任务在这一个线程中依次执行，每个任务内部仍按 --threads 并行合成
+void *Daemon_Encoder(void *arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&daemon_lock);
+        while (daemon_count == 0 && daemon_running) pthread_cond_wait(&daemon_ready, &daemon_lock);
+        if (daemon_count == 0) {
+            pthread_mutex_unlock(&daemon_lock);
+            break;
+        }
+        Daemon_Job job = daemon_queue[daemon_head];
+        daemon_head = (daemon_head + 1) % queue_depth;
+        daemon_count--;
+        daemon_busy = 1;
+        pthread_mutex_unlock(&daemon_lock);
+
+        Daemon_Encode(&job);
+
+        pthread_mutex_lock(&daemon_lock);
+        daemon_busy = 0;
+        pthread_mutex_unlock(&daemon_lock);
+    }
+
+    return NULL;
+}
+
+// 执行一个任务；输出为 "-" 时先写入临时文件（WAV 文件头须在结束时回填），再经连接传回
+int Daemon_Encode(Daemon_Job *job) {
+    char temp[] = "/tmp/sstvd-XXXXXX";
+    int stream = strcmp(job->output, "-") == 0;
+
+    if (stream) {
+        int fd = mkstemp(temp);
+        if (fd < 0) {
+            free(job->buffer);
+            return Daemon_Reply(job, -1, "无法创建临时文件");
+        }
+        close(fd);
+    }
+    filename = stream ? temp : job->output;
+
+    double start = Daemon_Clock();
+    int status = 0;
+    if (fm_deviation > 0) status = FM_Initialization();
+    if (status == 0 && job->buffer) {
+        status = Image_From_Buffer(job->buffer, job->width, job->height, job->width * Pixel_Bytes(job->format), job->format);
+        if (status == 0) status = Preprocessing(NULL, job->model);
+        Image_Free();
+    } else if (status == 0) {
+        status = Preprocessing(job->image, job->model);
+    }
+    double elapsed = Daemon_Clock() - start;
+    free(job->buffer);
+    job->buffer = NULL;
+
+    pthread_mutex_lock(&daemon_lock);
+    if (status == 0) {
+        daemon_stats.done++;
+        daemon_stats.samples += total_samples;
+        daemon_stats.audio += time_ns / 1e9;
+    } else {
+        daemon_stats.failed++;
+    }
+    daemon_stats.busy += elapsed;
+    daemon_stats.cache_hits = cache_hits;
+    daemon_stats.cache_misses = cache_misses;
+    pthread_mutex_unlock(&daemon_lock);
+
+    printf("任务 %s (%s) -> %s：%s，耗时 %.3f 秒\n", job->image[0] ? job->image : "<缓冲>", job->model,
+           job->output, status == 0 ? "完成" : "失败", elapsed);
+    fflush(stdout);
+
+    if (status != 0) {
+        if (stream) unlink(temp);
+        return Daemon_Reply(job, -1, "编码失败");
+    }
+    status = Daemon_Reply(job, 0, stream ? temp : NULL);
+    if (stream) unlink(temp);
+
+    return status;
+}
+
+// 回复并关闭连接：成功时为 OK <采样数> <输出文件名>，经连接传回时为 OK <采样数> <字节数> 后接文件内容；失败时为 ERR <原因>
+int Daemon_Reply(Daemon_Job *job, int status, char *message) {
+    char reply[DAEMON_LINE];
+    int length;
+
+    if (status != 0) {
+        length = snprintf(reply, sizeof(reply), "ERR %s\n", message);
+        Daemon_Send(job->fd, reply, length);
+        close(job->fd);
+        return -1;
+    }
+    if (!message) {
+        length = snprintf(reply, sizeof(reply), "OK %llu %s\n", (unsigned long long)total_samples, job->output);
+        Daemon_Send(job->fd, reply, length);
+        close(job->fd);
+        return 0;
+    }
+
+    FILE *fp = fopen(message, "rb");
+    struct stat info;
+    if (!fp || fstat(fileno(fp), &info) != 0) {
+        if (fp) fclose(fp);
+        length = snprintf(reply, sizeof(reply), "ERR 无法读取输出\n");
+        Daemon_Send(job->fd, reply, length);
+        close(job->fd);
+        return -1;
+    }
+    length = snprintf(reply, sizeof(reply), "OK %llu %lld\n", (unsigned long long)total_samples, (long long)info.st_size);
+    int sent = Daemon_Send(job->fd, reply, length);
+    unsigned char block[65536];
+    size_t count;
+    while (sent == 0 && (count = fread(block, 1, sizeof(block), fp)) > 0) {
+        sent = Daemon_Send(job->fd, block, count);
+    }
+    fclose(fp);
+    close(job->fd);
+
+    return sent;
+}
+
+// 实时统计，单行 键=值 格式，便于脚本解析
+int Daemon_Stats_Reply(int fd) {
+    char reply[DAEMON_LINE];
+
+    pthread_mutex_lock(&daemon_lock);
+    Daemon_Stats s = daemon_stats;
+    int queued = daemon_count, busy = daemon_busy;
+    pthread_mutex_unlock(&daemon_lock);
+
+    double uptime = Daemon_Clock() - daemon_start;
+    int length = snprintf(reply, sizeof(reply),
+        "uptime=%.3f accepted=%llu done=%llu failed=%llu rejected=%llu queued=%d busy=%d depth=%d max_depth=%d "
+        "samples=%llu audio_s=%.3f encode_s=%.3f realtime=%.2f jobs_per_min=%.2f cache_hits=%llu cache_misses=%llu\n",
+        uptime, (unsigned long long)s.accepted, (unsigned long long)s.done, (unsigned long long)s.failed,
+        (unsigned long long)s.rejected, queued, busy, queue_depth, s.max_depth, (unsigned long long)s.samples,
+        s.audio, s.busy, s.busy > 0 ? s.audio / s.busy : 0, uptime > 0 ? s.done * 60 / uptime : 0,
+        (unsigned long long)s.cache_hits, (unsigned long long)s.cache_misses);
+
+    return Daemon_Send(fd, reply, length);
+}
+
+// 逐字节读取一行请求，不越过其后的像素数据
+int Daemon_Read_Line(int fd, char *line, size_t size) {
+    size_t length = 0;
+    while (length + 1 < size) {
+        char c;
+        if (recv(fd, &c, 1, 0) != 1) return -1;
+        if (c == '\n') break;
+        if (c != '\r') line[length++] = c;
+    }
+    line[length] = 0;
+
+    return length + 1 < size ? 0 : -1;
+}
+
+// 读取定长数据
+int Daemon_Read(int fd, unsigned char *buffer, size_t size) {
+    for (size_t done = 0; done < size; ) {
+        ssize_t count = recv(fd, buffer + done, size - done, 0);
+        if (count <= 0) return -1;
+        done += count;
+    }
+
+    return 0;
+}
+
+// 发送全部数据
+int Daemon_Send(int fd, const void *data, size_t size) {
+    for (size_t done = 0; done < size; ) {
+        ssize_t count = send(fd, (const char *)data + done, size - done, MSG_NOSIGNAL);
+        if (count <= 0) return -1;
+        done += count;
+    }
+
+    return 0;
+}
+
+// 终止信号：停止接受新连接
+void Daemon_Signal(int number) {
+    (void)number;
+    daemon_signal = 1;
+}
+
+// 单调时钟 (秒)
+double Daemon_Clock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
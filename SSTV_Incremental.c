@@ -0,0 +1,277 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 19: Incremental re-encode reusing unchanged scan lines
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define LINE_STATE_MAGIC "SSTVLINE"        // 扫描线状态文件标识
+#define LINE_STATE_VERSION 3               // 状态文件格式版本
+#define LINE_BLOCK 4096                    // 交给输出级的采样块长度
+#define QUADRATURE_SCALE 32767.0           // 正交分量以 16 位整数保存的满幅值
+
+// 获取外部变量
+extern uint32_t sample_rate;
+extern uint64_t planned_samples;
+
+// 结构体：状态文件头
+typedef struct {
+    char magic[8];            // 文件标识
+    uint32_t version;         // 格式版本
+    uint32_t segments;        // 段数：VIS 段加每条扫描线一段，最后一段含结束段
+    uint64_t options[2];      // 模式与选项的散列，不同时整个状态失效
+} Line_State_Header;
+
+// 结构体：一段的记录，num_samples 为 0 表示该段无效
+typedef struct {
+    uint64_t hash[2];         // 段内音调（频率与采样数）的散列
+    uint64_t offset;          // 段的起始采样，也是正交分量在数据区中的起点
+    uint32_t num_samples;     // 段内采样数
+    uint32_t reserved;        // 对齐
+} Line_State_Segment;
+
+// 结构体：映射到内存的扫描线状态：每段以零相位起始的余弦与正弦分量（16 位），复用时旋转到该段实际的起始相位
+typedef struct {
+    Line_State_Header *header; // 文件头
+    Line_State_Segment *segments; // 段表
+    int16_t *quadrature;      // 交织的余弦、正弦分量，每个采样 4 字节
+    size_t size;              // 映射的字节数
+    int usable;               // 文件来自同一模式与选项，段表可以比较
+} Line_State;
+
+// 定义程序内全局变量
+char *line_state;             // 扫描线状态文件，非空时增量编码
+
+// 声明程序内函数
+int Incremental_Encode(char *, char *);
+size_t Segment_First(SSTV_Index *, uint32_t);
+void Segment_Hash(SSTV_Index *, uint32_t, uint64_t *);
+void Segment_Render(SSTV_Index *, uint32_t, double *, int16_t *);
+void Segment_Splice(int16_t *, uint32_t, uint64_t, double *);
+int Line_State_Open(char *, Line_State *, uint32_t, uint64_t *, uint64_t);
+void Line_State_Close(Line_State *);
+
+// 增量编码：建立时序索引后逐段比较音调散列，与上次相同的段由保存的正交分量按当前起始相位旋转拼接，不再合成；
+// 只有变化的扫描线以所选后端合成。起始相位由全部音调的前缀和给出，拼接处相位连续；复用段与直接合成最多相差 1 LSB
+int Incremental_Encode(char *image, char *model) {
+    SSTV_Index index;
+    Line_State state;
+    uint64_t options[2];
+
+    if (!Valid_Model(model)) {
+        printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
+        return -1;
+    }
+    if (Index_Build(&index, image, model) != 0) return -1;
+
+    uint32_t segments = index.tones.line_count + 1;
+    uint64_t total = index.tones.total_samples;
+    Hash_Init(options);
+    Cache_Options(options, model);
+    Synth_Buckets();
+    if (Line_State_Open(line_state, &state, segments, options, total) != 0) {
+        Index_Free(&index);
+        return -1;
+    }
+    if (!state.usable) printf("没有可用的先前状态，全部合成。\n");
+
+    // 逐段得到采样后立即写出，只需一段长度的缓冲
+    uint32_t longest = 0;
+    for (uint32_t s = 0; s < segments; s++) {
+        uint64_t end = s + 1 < segments ? index.starts[Segment_First(&index, s + 1)] : total;
+        uint32_t length = end - index.starts[Segment_First(&index, s)];
+        if (length > longest) longest = length;
+    }
+    double *audio = malloc(longest * sizeof(double));
+    if (!audio) {
+        printf("增量编码内存分配失败。\n");
+        Line_State_Close(&state);
+        Index_Free(&index);
+        return -1;
+    }
+
+    int status = 0;
+    uint32_t reused = 0;
+    planned_samples = total;
+    int opened = WAV_Open() == 0;
+    if (!opened) status = -1;
+    for (uint32_t s = 0; s < segments && status == 0; s++) {
+        Line_State_Segment *segment = &state.segments[s];
+        size_t first = Segment_First(&index, s);
+        uint64_t start = index.starts[first];
+        uint32_t num_samples = (s + 1 < segments ? index.starts[Segment_First(&index, s + 1)] : total) - start;
+        uint64_t hash[2];
+        Segment_Hash(&index, s, hash);
+
+        int16_t *quadrature = state.quadrature + 2 * start;
+        if (state.usable && segment->offset == start && segment->num_samples == num_samples &&
+            memcmp(segment->hash, hash, sizeof(hash)) == 0) {
+            Segment_Splice(quadrature, num_samples, index.phases[first], audio);
+            reused++;
+        } else {
+            // 先使记录失效再改写分量，中途退出时该段在下次运行中重新合成
+            segment->num_samples = 0;
+            Segment_Render(&index, s, audio, quadrature);
+            memcpy(segment->hash, hash, sizeof(hash));
+            segment->offset = start;
+            segment->num_samples = num_samples;
+        }
+        for (uint32_t done = 0; done < num_samples && status == 0; done += LINE_BLOCK) {
+            uint32_t count = num_samples - done < LINE_BLOCK ? num_samples - done : LINE_BLOCK;
+            status = WAV_Write_Audio(audio + done, count);
+        }
+    }
+    if (opened && WAV_Close() != 0) status = -1;
+    printf("增量编码: %u 段中复用 %u 段，重新合成 %u 段\n", segments, reused, segments - reused);
+
+    free(audio);
+    Line_State_Close(&state);
+    Index_Free(&index);
+
+    if (status == 0) printf("End.\n");
+    return status;
+}
+
+// 第 s 段的首个音调：第 0 段为首尾静音之前的静音与 VIS，其后每条扫描线一段
+size_t Segment_First(SSTV_Index *index, uint32_t s) {
+    return s == 0 ? 0 : index->tones.lines[s - 1];
+}
+
+// 段内音调的散列：频率与采样数相同的段波形相同，仅起始相位可能不同。每 256 个音调打包后散列一次
+void Segment_Hash(SSTV_Index *index, uint32_t s, uint64_t *hash) {
+    size_t first = Segment_First(index, s);
+    size_t last = s < index->tones.line_count ? Segment_First(index, s + 1) : index->tones.count;
+    uint64_t words[2 * 256];
+
+    Hash_Init(hash);
+    for (size_t k = first; k < last; ) {
+        size_t n = 0;
+        for (; k < last && n < 256; k++, n++) {
+            Tone *tone = &index->tones.tones[k];
+            memcpy(&words[2 * n], &tone->frequency, 8);
+            words[2 * n + 1] = tone->num_samples;
+        }
+        Hash_Update(hash, words, n * 2 * sizeof(uint64_t));
+    }
+}
+
+// 重新合成一段：采样与 Index_Render 逐位相同；同时以段起点为零相位、由旋转振荡器求出正交分量并量化为 16 位保存，不调用 libm
+void Segment_Render(SSTV_Index *index, uint32_t s, double *out, int16_t *quadrature) {
+    size_t first = Segment_First(index, s);
+    size_t last = s < index->tones.line_count ? Segment_First(index, s + 1) : index->tones.count;
+    uint64_t origin = index->phases[first];
+    double sin_part[LINE_BLOCK], cos_part[LINE_BLOCK];
+
+    for (size_t k = first; k < last; k++) {
+        double frequency = index->tones.tones[k].frequency;
+        uint32_t num_samples = index->tones.tones[k].num_samples;
+        uint64_t step = Synth_Step(frequency);
+        uint64_t relative = index->phases[k] - origin;
+        Synth_Tone(out, frequency, step, index->phases[k], 0, num_samples);
+        out += num_samples;
+
+        for (uint32_t i = 0; i < num_samples; i += LINE_BLOCK) {
+            uint32_t end = num_samples - i < LINE_BLOCK ? num_samples : i + LINE_BLOCK;
+            if (frequency == 0) {
+                double s0, c0;
+                Synth_Phase(relative, &s0, &c0);
+                for (uint32_t j = i; j < end; j++) {
+                    double gain = Synth_Fade(j);
+                    sin_part[j - i] = s0 * gain;
+                    cos_part[j - i] = c0 * gain;
+                }
+            } else {
+                Synth_Rotate(sin_part, cos_part, step, relative, i, end);
+            }
+            // 加偏移后截断即为四舍五入，避免逐点调用 floor
+            for (uint32_t j = 0; j < end - i; j++) {
+                *quadrature++ = (int16_t)((int32_t)(cos_part[j] * QUADRATURE_SCALE + 32768.5) - 32768);
+                *quadrature++ = (int16_t)((int32_t)(sin_part[j] * QUADRATURE_SCALE + 32768.5) - 32768);
+            }
+        }
+    }
+}
+
+// 拼接复用的段：sin(θ+φ) = sin θ·cos φ + cos θ·sin φ，φ 为该段在本次发送中的起始相位
+void Segment_Splice(int16_t *quadrature, uint32_t num_samples, uint64_t phase, double *out) {
+    double sin_phi, cos_phi;
+    Synth_Phase(phase, &sin_phi, &cos_phi);
+    sin_phi /= QUADRATURE_SCALE;
+    cos_phi /= QUADRATURE_SCALE;
+
+    for (uint32_t i = 0; i < num_samples; i++) {
+        out[i] = quadrature[2 * i + 1] * cos_phi + quadrature[2 * i] * sin_phi;
+    }
+}
+
+// 映射状态文件：长度、文件头与本次一致时原地复用，否则重建为空状态。
+// 复用的段只读不写，变化的段原地改写，一次编码的文件读写量与变化的扫描线数成正比
+int Line_State_Open(char *path, Line_State *state, uint32_t segments, uint64_t *options, uint64_t total) {
+    memset(state, 0, sizeof(Line_State));
+    size_t table = sizeof(Line_State_Header) + segments * sizeof(Line_State_Segment);
+    size_t size = table + total * 2 * sizeof(int16_t);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        printf("无法打开扫描线状态: %s\n", path);
+        return -1;
+    }
+    Line_State_Header header;
+    int usable = (size_t)info.st_size == size && pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+                 memcmp(header.magic, LINE_STATE_MAGIC, 8) == 0 && header.version == LINE_STATE_VERSION &&
+                 header.segments == segments && memcmp(header.options, options, sizeof(header.options)) == 0;
+    if (!usable && (ftruncate(fd, 0) != 0 || ftruncate(fd, size) != 0)) {
+        close(fd);
+        printf("无法写入扫描线状态: %s\n", path);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | (usable ? MAP_POPULATE : 0), fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("无法映射扫描线状态: %s\n", path);
+        return -1;
+    }
+    state->header = map;
+    state->segments = (Line_State_Segment *)((char *)map + sizeof(Line_State_Header));
+    state->quadrature = (int16_t *)((char *)map + table);
+    state->size = size;
+    state->usable = usable;
+
+    // 新文件的段表全为零，所有段均无效
+    if (!usable) {
+        memcpy(state->header->magic, LINE_STATE_MAGIC, 8);
+        state->header->version = LINE_STATE_VERSION;
+        state->header->segments = segments;
+        memcpy(state->header->options, options, sizeof(state->header->options));
+    }
+
+    return 0;
+}
+
+// 解除映射，改写的页由内核写回文件
+void Line_State_Close(Line_State *state) {
+    if (state->header) munmap(state->header, state->size);
+    memset(state, 0, sizeof(Line_State));
+}
@@ -0,0 +1,187 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 9: Random-access sample generation from a timing index
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define INDEX_BLOCK 4096                   // 区间输出时每次生成的采样块长度
+
+// 获取外部变量
+extern uint32_t sample_rate;
+extern uint64_t planned_samples;
+
+// 声明程序内函数
+int Index_Build(SSTV_Index *, char *, char *);
+int Index_Alloc(SSTV_Index *);
+int Index_Phases(SSTV_Index *, uint64_t *);
+void Index_Sum(SSTV_Index *, size_t, size_t, uint64_t *, uint64_t *);
+uint64_t Index_Scan(SSTV_Index *, size_t, size_t, uint64_t, uint64_t);
+int Index_Render(SSTV_Index *, uint64_t, uint64_t, double *);
+uint64_t Index_Line_Start(SSTV_Index *, size_t);
+void Index_Free(SSTV_Index *);
+int Index_Output(char *, char *, uint64_t, uint64_t);
+
+// 建立索引：记录整个发送（首尾静音、VIS、图像与结束段）的音调时序，再逐音调推算起始采样与相位
+// 起始相位是各音调相位推进的前缀和，只需整数运算，不生成任何波形
+int Index_Build(SSTV_Index *index, char *image, char *model) {
+    memset(index, 0, sizeof(SSTV_Index));
+    index->sample_rate = sample_rate;
+
+    WAV_Capture_Begin(&index->tones);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    int status = Encode_Image(image, model);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    WAV_Capture_End();
+    if (status != 0) {
+        Index_Free(index);
+        return -1;
+    }
+
+    uint64_t phase = 0;
+    if (Index_Phases(index, &phase) != 0) {
+        Index_Free(index);
+        return -1;
+    }
+
+    return 0;
+}
+
+// 为每个音调的起始采样与起始相位分配空间
+int Index_Alloc(SSTV_Index *index) {
+    size_t count = index->tones.count;
+    index->starts = malloc(count * sizeof(uint64_t));
+    index->phases = malloc(count * sizeof(uint64_t));
+    if (!index->starts || !index->phases) {
+        printf("时序索引内存分配失败。\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+// 由已记录的音调时序推算每个音调的起始采样与起始相位；phase 传入起点的相位，返回终点的相位
+// 两者都是整数前缀和，与 WAV_Write 的相位累加完全相同，区间生成的结果与顺序生成逐位一致
+int Index_Phases(SSTV_Index *index, uint64_t *phase) {
+    if (Index_Alloc(index) != 0) return -1;
+    *phase = Index_Scan(index, 0, index->tones.count, 0, *phase);
+
+    return 0;
+}
+
+// 音调 [first, last) 的总采样数与总相位推进，供分段并行求前缀和
+void Index_Sum(SSTV_Index *index, size_t first, size_t last, uint64_t *samples, uint64_t *phase) {
+    uint64_t n = 0, p = 0;
+    for (size_t k = first; k < last; k++) {
+        Tone *tone = &index->tones.tones[k];
+        n += tone->num_samples;
+        p += Phase_Step(tone->frequency) * tone->num_samples;
+    }
+    *samples = n;
+    *phase = p;
+}
+
+// 由区间起点的采样序号与相位，写出音调 [first, last) 各自的起始采样与起始相位，返回区间终点的相位
+uint64_t Index_Scan(SSTV_Index *index, size_t first, size_t last, uint64_t start, uint64_t phase) {
+    for (size_t k = first; k < last; k++) {
+        Tone *tone = &index->tones.tones[k];
+        index->starts[k] = start;
+        index->phases[k] = phase;
+        start += tone->num_samples;
+        phase += Phase_Step(tone->frequency) * tone->num_samples;
+    }
+
+    return phase;
+}
+
+// 生成区间 [a, b) 的归一化采样；索引建立后只读，可被多个线程同时使用
+int Index_Render(SSTV_Index *index, uint64_t a, uint64_t b, double *out) {
+    uint64_t total = index->tones.total_samples;
+    if (b > total) b = total;
+    if (a >= b) return 0;
+
+    // 二分查找包含采样 a 的音调
+    size_t low = 0, high = index->tones.count - 1;
+    while (low < high) {
+        size_t mid = (low + high + 1) / 2;
+        if (index->starts[mid] <= a) low = mid;
+        else high = mid - 1;
+    }
+
+    for (size_t k = low; a < b; k++) {
+        double frequency = index->tones.tones[k].frequency;
+        uint32_t i = a - index->starts[k];
+        uint32_t end = index->tones.tones[k].num_samples;
+        if (index->starts[k] + end > b) end = b - index->starts[k];
+        Synth_Tone(out, frequency, Synth_Step(frequency), index->phases[k], i, end);
+        out += end - i;
+        a = index->starts[k] + end;
+    }
+
+    return 0;
+}
+
+// 第 line 条扫描线的起始采样
+uint64_t Index_Line_Start(SSTV_Index *index, size_t line) {
+    return index->starts[index->tones.lines[line]];
+}
+
+// 释放索引
+void Index_Free(SSTV_Index *index) {
+    Tone_Free(&index->tones);
+    free(index->starts);
+    free(index->phases);
+    memset(index, 0, sizeof(SSTV_Index));
+}
+
+// 只生成并写出发送内容中 [a, b) 区间的采样，用于续传中断的发送或按需提供片段
+int Index_Output(char *image, char *model, uint64_t a, uint64_t b) {
+    SSTV_Index index;
+    if (!Valid_Model(model)) {
+        printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
+        return -1;
+    }
+    if (Index_Build(&index, image, model) != 0) return -1;
+
+    uint64_t total = index.tones.total_samples;
+    if (b > total) b = total;
+    printf("发送共 %llu 个采样 (%.3f 秒)，%zu 条扫描线，输出区间 [%llu, %llu)\n",
+           (unsigned long long)total, (double)total / sample_rate, index.tones.line_count,
+           (unsigned long long)a, (unsigned long long)(a < b ? b : a));
+
+    // 区间长度已知，内存映射输出时据此预分配
+    planned_samples = a < b ? b - a : 0;
+    if (WAV_Open() != 0) {
+        Index_Free(&index);
+        return -1;
+    }
+    int status = 0;
+    double buffer[INDEX_BLOCK];
+    for (uint64_t done = a; done < b && status == 0; ) {
+        uint32_t count = b - done < INDEX_BLOCK ? b - done : INDEX_BLOCK;
+        Index_Render(&index, done, done + count, buffer);
+        status = WAV_Write_Audio(buffer, count);
+        done += count;
+    }
+    if (WAV_Close() != 0) status = -1;
+    Index_Free(&index);
+
+    if (status == 0) printf("End.\n");
+    return status;
+}
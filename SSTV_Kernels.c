@@ -0,0 +1,203 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 21: Mode kernels specialised at compile time from the scan line timing tables
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "header.h"
+
+// 获取外部变量
+extern unsigned char *pixels;
+extern int stride;
+extern int pixel_format;
+extern uint32_t sample_rate;
+extern uint64_t phase_acc;
+extern uint64_t time_ns;
+extern uint64_t timeline_samples;
+extern Tone_List *capture;
+extern PCM_Block *recording;
+extern int iq_format;
+extern double fm_deviation;
+extern int synth_backend;
+
+// 结构体：专用函数的合成状态，展开后全部为局部变量
+typedef struct {
+    uint64_t time;            // 时间轴位置 (纳秒)
+    uint64_t timeline;        // 已分配的采样数
+    uint64_t phase;           // 相位累加器
+    uint32_t rate;            // 采样率
+    uint32_t fill;            // 行缓冲中的采样数
+    uint32_t tones;           // 行缓冲中的音调数
+    double *buffer;           // 一次迭代的采样
+    int status;               // 出错时为 -1
+} Kernel_State;
+
+// 定义程序内全局变量
+int kernels_enabled = 1;      // 是否使用专用函数，为 0 时始终走通用的 Generate_* 路径
+
+// 声明程序内函数
+int Kernel_Usable();
+int Kernel_Begin(Kernel_State *, uint64_t);
+int Kernel_Flush(Kernel_State *);
+int Kernel_End(Kernel_State *);
+int Kernel_Scottie_DX();
+int Kernel_PD_120();
+int Kernel_Robot_36();
+
+// 专用函数覆盖逐音调合成与时序记录；复基带直接输出与缓存录制仍走通用路径
+int Kernel_Usable() {
+    return kernels_enabled && !recording && !(iq_format && fm_deviation == 0);
+}
+
+// 像素的 RGB 分量，与 Channel_Lookup 相同
+static inline __attribute__((always_inline)) void Kernel_RGB(int x, int y, double *R, double *G, double *B) {
+    unsigned char *pixel = pixels + (size_t)y * stride;
+    if (pixel_format == PIXEL_GRAY8) {
+        *R = *G = *B = (double)pixel[x];
+    } else {
+        pixel += x * 3;
+        *R = (double)pixel[0];
+        *G = (double)pixel[1];
+        *B = (double)pixel[2];
+    }
+}
+
+// 查表后端把取值取整到 8 位级，与 Channel_Value 相同
+static inline __attribute__((always_inline)) double Kernel_Level(double value) {
+    return synth_backend == SYNTH_LUT ? floor(value + 0.5) : value;
+}
+
+// 各颜色通道的取值，公式与 Channel_Lookup 逐字相同；相机 YUV 输入交给 YUV_Value
+#define KERNEL_CHANNEL(name, key, expression) \
+static inline __attribute__((always_inline)) double Kernel_##name(int x, int y) { \
+    double R, G, B; \
+    if (pixel_format >= PIXEL_NV12) return Kernel_Level(YUV_Value(key, x, y)); \
+    Kernel_RGB(x, y, &R, &G, &B); \
+    return Kernel_Level(expression); \
+}
+KERNEL_CHANNEL(R, "r", R)
+KERNEL_CHANNEL(G, "g", G)
+KERNEL_CHANNEL(B, "b", B)
+KERNEL_CHANNEL(Y, "y", 16.0 + (.003906 * ((65.738 * R) + (129.057 * G) + (25.064 * B))))
+KERNEL_CHANNEL(RY, "ry", 128.0 + (.003906 * ((112.439 * R) + (-94.154 * G) + (-18.285 * B))))
+KERNEL_CHANNEL(BY, "by", 128.0 + (.003906 * ((-37.945 * R) + (-74.494 * G) + (112.439 * B))))
+
+// 时间轴上 t 纳秒处的采样序号，与 Sample_At 相同；除数为常量，编译为乘法
+static inline __attribute__((always_inline)) uint64_t Kernel_Sample_At(uint64_t t_ns, uint32_t rate) {
+    return t_ns / 1000000000 * rate + t_ns % 1000000000 * rate / 1000000000;
+}
+
+// 一个音调：与 WAV_Write 相同地推进时间轴与相位；记录时序时追加到时序表，否则合成到行缓冲
+static inline __attribute__((always_inline)) void Kernel_Emit(Kernel_State *k, double frequency, uint64_t duration_ns) {
+    k->time += duration_ns;
+    uint64_t end = Kernel_Sample_At(k->time, k->rate);
+    uint32_t num_samples = end > k->timeline ? end - k->timeline : 0;
+    k->timeline += num_samples;
+
+    if (capture) {
+        if (Tone_Append(capture, frequency, num_samples) != 0) k->status = -1;
+        return;
+    }
+    STATS_BEGIN(t);
+    uint64_t step = Synth_Step(frequency);
+    Synth_Tone(k->buffer + k->fill, frequency, step, k->phase, 0, num_samples);
+    STATS_END(STAGE_SYNTH, t);
+    k->phase += step * num_samples;
+    k->fill += num_samples;
+    k->tones++;
+}
+
+// 由时序表展开的语句与常量表达式
+#define PX(channel, dy) Kernel_##channel(col, row + (dy))
+#define AVG(channel, a, b) (Kernel_##channel(col, row + (a)) + Kernel_##channel(col, row + (b) <= last ? row + (b) : row + (a))) / 2
+#define KERNEL_LINE() Kernel_Flush(&k); WAV_Line();
+#define KERNEL_TONE(frequency, ns) Kernel_Emit(&k, frequency, ns);
+#define KERNEL_SCAN(value, count, ns) { \
+    double frequencies[count]; \
+    STATS_BEGIN(t); \
+    for (int col = 0; col < (count); col++) frequencies[col] = 1500 + value * COLOR_FREQ_MULT; \
+    STATS_END(STAGE_PIXEL, t); \
+    for (int col = 0; col < (count); col++) Kernel_Emit(&k, frequencies[col], ns); \
+}
+
+// 展开一个模式的专用函数：先发送首行前的音调，再按每次迭代 step 行扫描；行缓冲按一次迭代的常量时长分配
+#define KERNEL_MODE(name, prefix, rows, step) \
+int Kernel_##name() { \
+    Kernel_State k; \
+    const uint64_t start_ns = 0 prefix##_START(KERNEL_NS_LINE, KERNEL_NS_TONE, KERNEL_NS_SCAN); \
+    const uint64_t rows_ns = 0 prefix##_ROWS(KERNEL_NS_LINE, KERNEL_NS_TONE, KERNEL_NS_SCAN); \
+    if (Kernel_Begin(&k, start_ns > rows_ns ? start_ns : rows_ns) != 0) return -1; \
+    int row = 0; \
+    const int last = (rows) - 1; \
+    (void)row; \
+    (void)last; \
+    prefix##_START(KERNEL_LINE, KERNEL_TONE, KERNEL_SCAN) \
+    for (row = 0; row < (rows) && k.status == 0; row += (step)) { \
+        prefix##_ROWS(KERNEL_LINE, KERNEL_TONE, KERNEL_SCAN) \
+    } \
+    return Kernel_End(&k); \
+}
+
+KERNEL_MODE(Scottie_DX, SCOTTIE_DX, 256, 1)
+KERNEL_MODE(PD_120, PD_120, 496, 2)
+KERNEL_MODE(Robot_36, ROBOT_36, 240, 2)
+
+// 取出全局时间轴与相位，并分配一次迭代的行缓冲（多留每个音调最多一个采样的取整余量由 +2 与最长时长覆盖）
+int Kernel_Begin(Kernel_State *k, uint64_t longest_ns) {
+    k->time = time_ns;
+    k->timeline = timeline_samples;
+    k->phase = phase_acc;
+    k->rate = sample_rate;
+    k->fill = 0;
+    k->tones = 0;
+    k->status = 0;
+    k->buffer = NULL;
+    if (capture) return 0;
+
+    k->buffer = malloc((Kernel_Sample_At(longest_ns, sample_rate) + 2) * sizeof(double));
+    if (!k->buffer) {
+        printf("专用合成函数的行缓冲内存分配失败。\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+// 写回时间轴与相位，并把行缓冲整块交给输出级
+int Kernel_Flush(Kernel_State *k) {
+    time_ns = k->time;
+    timeline_samples = k->timeline;
+    phase_acc = k->phase;
+    if (k->fill == 0) return 0;
+
+    STATS_ADD(tones, k->tones);
+    for (uint32_t done = 0; done < k->fill && k->status == 0; done += 4096) {
+        uint32_t count = k->fill - done < 4096 ? k->fill - done : 4096;
+        if (WAV_Write_Audio(k->buffer + done, count) != 0) k->status = -1;
+    }
+    k->fill = 0;
+    k->tones = 0;
+
+    return k->status;
+}
+
+// 输出最后一次迭代并释放行缓冲
+int Kernel_End(Kernel_State *k) {
+    Kernel_Flush(k);
+    free(k->buffer);
+
+    return k->status;
+}
@@ -0,0 +1,244 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 4: Frequency-division mixing of multiple SSTV carriers
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define MIX_BLOCK 4096                     // 每次合成的采样块长度
+#define MAX_CARRIERS 8                     // 最多同时混合的载波数
+#define SOFT_KNEE 0.8                      // 软限幅的起始幅度
+
+// 结构体：单个载波，拥有独立的音调时序与数控振荡器
+typedef struct {
+    Tone_List schedule;       // 载波的音调时序
+    double offset;            // 频率偏移 (Hz)
+    double gain;              // 载波增益
+    double phase;             // 振荡器相位 (弧度)
+    uint32_t delay;           // 起始时间 (采样数)
+    size_t tone;              // 当前音调序号
+    uint32_t remaining;       // 当前音调剩余采样数
+    double increment;         // 当前音调的每采样相位增量
+} Carrier;
+
+// 获取外部变量
+extern uint32_t sample_rate;
+
+// 定义程序内全局变量
+double headroom_db = 1.0;     // 混合输出的峰值余量 (dB)
+int soft_clip = 0;            // 是否使用软限幅
+Carrier carriers[MAX_CARRIERS];
+int carrier_count;
+
+// 声明程序内函数
+int Mixer_Load(char *);
+void Mixer_Free();
+int Mixer_Render(float *, uint32_t);
+double Mixer_Clip(double, uint64_t *);
+
+// 混合器入口：按列表为每个载波记录音调时序，再逐块合成写入同一 WAV 容器
+int Mixer(char *list) {
+
+    if (Mixer_Load(list) != 0) return -1;
+
+    // 峰值按各载波增益之和归一化，再留出指定余量；余量为负时允许过载并由限幅处理
+    double total_gain = 0;
+    uint64_t length = 0;
+    for (int c = 0; c < carrier_count; c++) {
+        total_gain += fabs(carriers[c].gain);
+        uint64_t end = carriers[c].delay + carriers[c].schedule.total_samples;
+        if (end > length) length = end;
+    }
+    double master = pow(10, -headroom_db / 20) / total_gain;
+
+    if (WAV_Initialization() != 0) {
+        Mixer_Free();
+        return -1;
+    }
+
+    float mix[MIX_BLOCK];
+    double buffer[MIX_BLOCK];
+    uint64_t clipped = 0;
+    for (uint64_t done = 0; done < length; ) {
+        uint32_t count = length - done < MIX_BLOCK ? length - done : MIX_BLOCK;
+        Mixer_Render(mix, count);
+        for (uint32_t i = 0; i < count; i++) {
+            buffer[i] = Mixer_Clip(mix[i] * master, &clipped);
+        }
+        WAV_Write_Audio(buffer, count);
+        done += count;
+    }
+
+    WAV_Finalization();
+
+    printf("已混合 %d 路载波，共 %llu 个采样，限幅 %llu 个采样。\n", carrier_count, (unsigned long long)length, (unsigned long long)clipped);
+
+    Mixer_Free();
+
+    return 0;
+}
+
+// 读取混合列表：每行为 <图像文件名> <调制模式> <频率偏移Hz> [增益] [起始毫秒] [初始相位度]
+int Mixer_Load(char *list) {
+
+    FILE *fp = fopen(list, "r");
+    if (!fp) {
+        printf("混合列表打开失败: %s\n", list);
+        return -1;
+    }
+
+    char line[1024];
+    carrier_count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char image[1024], model[64];
+        double offset, gain = 1, start_ms = 0, phase_deg = 0;
+
+        line[strcspn(line, "\r\n")] = 0;
+        if (line[strspn(line, " \t")] == 0 || line[strspn(line, " \t")] == '#') continue;
+        if (sscanf(line, "%1023s %63s %lf %lf %lf %lf", image, model, &offset, &gain, &start_ms, &phase_deg) < 3) {
+            printf("混合列表格式错误: %s\n", line);
+            fclose(fp);
+            Mixer_Free();
+            return -1;
+        }
+        if (!Valid_Model(model)) {
+            printf("混合列表中有错误的调制模式: %s\n", model);
+            fclose(fp);
+            Mixer_Free();
+            return -1;
+        }
+        if (carrier_count == MAX_CARRIERS) {
+            printf("最多支持 %d 路载波。\n", MAX_CARRIERS);
+            fclose(fp);
+            Mixer_Free();
+            return -1;
+        }
+
+        // 记录该载波的完整音调时序：VIS、图像与结束段
+        Carrier *carrier = &carriers[carrier_count];
+        memset(carrier, 0, sizeof(Carrier));
+        carrier->offset = offset;
+        carrier->gain = gain;
+        carrier->phase = phase_deg * PI / 180;
+        carrier->delay = (uint32_t)(start_ms * sample_rate / 1000);
+        WAV_Capture_Begin(&carrier->schedule);
+        int status = Encode_Image(image, model);
+        WAV_Capture_End();
+        carrier_count++;
+        if (status != 0) {
+            fclose(fp);
+            Mixer_Free();
+            return -1;
+        }
+    }
+    fclose(fp);
+
+    if (carrier_count == 0) {
+        printf("混合列表为空: %s\n", list);
+        return -1;
+    }
+
+    // 峰值按增益之和归一化，和为 0 时无法归一化
+    double total_gain = 0;
+    for (int c = 0; c < carrier_count; c++) total_gain += fabs(carriers[c].gain);
+    if (total_gain == 0) {
+        printf("混合列表中各载波的增益均为 0: %s\n", list);
+        Mixer_Free();
+        return -1;
+    }
+
+    return 0;
+}
+
+// 释放已读取的各载波音调时序
+void Mixer_Free() {
+    for (int c = 0; c < carrier_count; c++) Tone_Free(&carriers[c].schedule);
+    carrier_count = 0;
+}
+
+// 合成一个采样块：各载波的振荡器分别推进后求和
+int Mixer_Render(float *mix, uint32_t count) {
+
+    memset(mix, 0, count * sizeof(float));
+
+    for (int c = 0; c < carrier_count; c++) {
+        Carrier *carrier = &carriers[c];
+        uint32_t i = 0;
+
+        // 起始时间之前保持静默
+        if (carrier->delay > 0) {
+            uint32_t skip = carrier->delay < count ? carrier->delay : count;
+            carrier->delay -= skip;
+            i = skip;
+        }
+
+        while (i < count) {
+
+            // 当前音调结束时切换到下一个音调，并将相位折回以保持精度
+            if (carrier->remaining == 0) {
+                if (carrier->tone == carrier->schedule.count) break;
+                Tone *tone = &carrier->schedule.tones[carrier->tone++];
+                carrier->remaining = tone->num_samples;
+                carrier->increment = 2 * PI * (tone->frequency + carrier->offset) / sample_rate;
+                carrier->phase = fmod(carrier->phase, 2 * PI);
+                continue;
+            }
+
+            uint32_t run = carrier->remaining < count - i ? carrier->remaining : count - i;
+            double phase = carrier->phase;
+            double increment = carrier->increment;
+            float gain = carrier->gain;
+            Tone *tone = &carrier->schedule.tones[carrier->tone - 1];
+
+            // 静默段不叠加频率偏移，相位保持不变，按 Synth_Fade 衰减到零
+            if (tone->frequency == 0) {
+                uint32_t position = tone->num_samples - carrier->remaining;
+                for (uint32_t k = 0; k < run; k++) {
+                    mix[i + k] += gain * (float)(sin(phase) * Synth_Fade(position + k));
+                }
+                carrier->remaining -= run;
+                i += run;
+                continue;
+            }
+            for (uint32_t k = 0; k < run; k++) {
+                mix[i + k] += gain * (float)sin(phase + increment * k);
+            }
+            carrier->phase = phase + increment * run;
+            carrier->remaining -= run;
+            i += run;
+        }
+    }
+
+    return 0;
+}
+
+// 限幅到 [-1, 1]：硬限幅直接截断，软限幅在拐点以上平滑压缩
+double Mixer_Clip(double value, uint64_t *clipped) {
+    double magnitude = fabs(value);
+
+    if (soft_clip && magnitude > SOFT_KNEE) {
+        magnitude = SOFT_KNEE + (1 - SOFT_KNEE) * tanh((magnitude - SOFT_KNEE) / (1 - SOFT_KNEE));
+        (*clipped)++;
+    } else if (magnitude > 1) {
+        magnitude = 1;
+        (*clipped)++;
+    }
+
+    return value < 0 ? -magnitude : magnitude;
+}
@@ -13,17 +13,12 @@ Developer & Acknowledgments:
 License: MIT License
 */
 
-// 定义程序内全局常量
-#define STB_IMAGE_IMPLEMENTATION          // stb预处理器
-#define STB_IMAGE_RESIZE_IMPLEMENTATION   // stb预处理器 
-#define COLOR_FREQ_MULT 3.1372549         // 颜色频率乘数，用于转换RGB值到频率(0-255映射到1500~2300)
-
+#include <math.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "header.h"
-#include "stb_image.h"
 
 // 定义程序内全局变量
 unsigned char *pixels;        // 图像原始像素数据
@@ -31,70 +26,533 @@ char *filename;               // WAV 容器文件名
 int channels;                 // 图像通道数
 int height;                   // 图像高度
 int width;                    // 图像宽度
+int stride;                   // 图像每行字节数
+int pixel_format;             // 像素格式
+int end_tones = 1;            // 是否在图像后发送结束音
+char *fsk_id;                 // FSK 呼号识别，为空时不发送
+PCM_Block trailer;            // 结束音与 FSK ID 的缓存音频
+int trailer_ready;            // 结束段缓存是否已渲染
+uint32_t trailer_rate;        // 缓存渲染时的采样率
+uint64_t trailer_position;    // 缓存起点的亚采样位置
+int trailer_end;              // 缓存是否含结束音
+char *trailer_fsk;            // 缓存中的 FSK 呼号副本，为空时不含 FSK ID
+double gap_ms = 1000;         // 播放列表中图像之间的间隔
+int thread_count;             // 工作线程数，0 表示按处理器数
+int range;                    // 是否只输出部分区间
+uint64_t range_start;         // 输出区间起点 (采样)
+uint64_t range_end;           // 输出区间终点 (采样)
+int stats_json;               // 以 JSON 格式打印性能统计
+
+// 获取外部变量
+extern double headroom_db;
+extern int soft_clip;
+extern uint32_t sample_rate;
+extern int iq_format;
+extern double iq_offset;
+extern double fm_deviation;
+extern uint32_t fm_rate;
+extern int sample_format;
+extern int force_rf64;
+extern int mmap_io;
+extern double pass_s;
+extern char *min_mode;
+extern uint64_t planned_samples;
+extern int raw_width;
+extern int raw_height;
+extern int raw_format;
+extern int queue_depth;
+extern char *cache_dir;
+extern double cache_size_mb;
+extern char *line_state;
+extern int synth_backend;
+extern int kernels_enabled;
+extern uint64_t phase_acc;
+extern uint64_t time_ns;
 
 // 声明内部函数
 double Channel_Value(char *, int, int);
+double Channel_Lookup(char *, int, int);
+int Scan_Write(char *, int, int, int, double);
 int Preprocessing(char *, char *);
+int Playlist(char *);
 int Generate_VIS(char *);
 int Generate_End();
+int Generate_FSK_ID(char *);
+int Generate_Trailer();
 int Generate_Scottie_DX();
 int Generate_Robot_36();
 int Generate_PD_120();
 
+// 模式表：首行前的时长与每条扫描线的时长由 header.h 中的时序表在编译时累加得到，
+// 修改时序时只需修改时序表与对应的 Generate_* 函数，两者的一致性由 --verify-timing 校验
+const SSTV_Mode modes[] = {
+    // 分离 1.5ms ×3、同步 9ms、三色各 320 × 1.08ms；首行前有 9ms 起始同步
+    {"Scottie-DX", "1001100", Generate_Scottie_DX, Kernel_Scottie_DX, 320, 256, 256, KERNEL_START_NS(SCOTTIE_DX), KERNEL_LINE_NS(SCOTTIE_DX), 2},
+    // 每两行：同步 20ms、Porch 2.08ms、Y/RY/BY/Y 各 640 × 0.19ms
+    {"PD-120", "1011111", Generate_PD_120, Kernel_PD_120, 640, 496, 248, KERNEL_START_NS(PD_120), KERNEL_LINE_NS(PD_120), 3},
+    // 同步 9ms、Porch 3ms、Y 320 × 0.275ms、分离 4.5ms、Porch 1.5ms、色差 320 × 0.1375ms
+    {"Robot-36", "0001000", Generate_Robot_36, Kernel_Robot_36, 320, 240, 240, KERNEL_START_NS(ROBOT_36), KERNEL_LINE_NS(ROBOT_36), 1},
+};
+const int mode_count = sizeof(modes) / sizeof(modes[0]);
+
 
 // 程序总入口点
 int main(int argc, char *argv[]) {
 
+    // 基准测试
+    if (argc == 3 && strcmp(argv[1], "--bench") == 0) return Benchmark(argv[2]);
+
+    // 频谱分析
+    if (argc >= 3 && strcmp(argv[1], "--analyze") == 0) return Spectrum_Main(argc, argv);
+
+    // 时序校验
+    if (argc <= 3 && argc >= 2 && strcmp(argv[1], "--verify-timing") == 0) return Timing_Verify(argc == 3 ? argv[2] : NULL);
+
+    // 只做规划：--plan <模式> [选项]
+    int plan = argc >= 3 && strcmp(argv[1], "--plan") == 0;
+
+    // 守护进程：--daemon <套接字> [选项]
+    int serve = argc >= 3 && strcmp(argv[1], "--daemon") == 0;
+
     // 命令行提示
-    if (argc != 4 || strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
-        printf("用法: ./sstv <'Image Filename'> <'SSTV Model'> <'Output Filename'>\n");
-        printf("例如: ./sstv 'test.jpg' 'Robot-36' 'Output.wav'\n");
+    if ((argc < 4 && !plan && !serve) || strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
+        printf("用法: ./sstv <'Image Filename'> <'SSTV Model'> <'Output Filename'> [选项]\n");
+        printf("      ./sstv --playlist <'Playlist Filename'> <'Output Filename'> [选项]\n");
+        printf("      ./sstv --mix <'Mix List Filename'> <'Output Filename'> [选项]\n");
+        printf("      ./sstv --schedule <'Queue Filename'> <'Output Filename'> --pass <秒> [选项]\n");
+        printf("      ./sstv --batch <'Playlist Filename'> <'Output Directory'> [选项]\n");
+        printf("      ./sstv --plan <'SSTV Model'> [选项]\n");
+        printf("      ./sstv --daemon <'Socket Path'> [--queue N] [选项]\n");
+        printf("      ./sstv --verify-timing [<'SSTV Model'>]\n");
+        printf("      ./sstv --analyze <'WAV Filename'...> [--fft N] [--channel 下限Hz 上限Hz]\n");
+        printf("      ./sstv --bench <fm|fft|synth|kernels>\n");
+        printf("例如: ./sstv 'test.jpg' 'Robot-36' 'Output.wav' --fskid 'BG7ZDQ'\n");
         printf("支持的SSTV模式:\n 1.Scottie-DX\n 2.PD-120\n 3.Robot-36\n");
+        printf("选项:\n");
+        printf(" --no-end          不发送图像后的结束音\n");
+        printf(" --fskid <呼号>    在结束段发送 MMSSTV 格式的 FSK 呼号识别\n");
+        printf(" --gap <毫秒>      连续发送时图像之间的间隔，默认 %.0f 毫秒\n", gap_ms);
+        printf(" --rate <Hz>       合成采样率，默认 %d Hz\n", SAMPLE_RATE);
+        printf(" --format <pcm16|pcm24|float32|flac>  输出采样格式，默认 pcm16，flac 为无损压缩\n");
+        printf(" --synth <libm|lut|rotator>  波形合成后端，默认 libm；lut 按像素取值查表，像素取值取整到 8 位级；rotator 为复数旋转振荡器\n");
+        printf(" --no-kernel       不使用各模式的专用合成函数，改走通用的逐音调路径\n");
+        printf(" --threads <N>     工作线程数，默认按处理器数，用于 FLAC 编码与波形合成\n");
+        printf(" --rf64            始终写出 RF64 格式，超过 4 GiB 时自动切换\n");
+        printf(" --iq <cf32|cs16>  输出复基带 I/Q 裸数据（float32 或 int16 交织）而非 WAV\n");
+        printf(" --iq-offset <Hz>  I/Q 输出的频率偏移，默认 0 即音频上边带\n");
+        printf(" --fm <Hz>         以指定频偏调频，输出射频采样率的 I/Q\n");
+        printf(" --fm-rate <Hz>    调频输出的射频采样率，须为合成采样率的整数倍，默认 50 倍\n");
+        printf(" --mmap            以内存映射读入图像，输出 WAV 时预分配并映射输出文件\n");
+        printf(" --raw <宽>x<高> <rgb24|gray8|nv12|yuyv|i420>  输入为无文件头的裸帧\n");
+        printf(" --range <起> <止>  只生成发送内容中第 [起, 止) 个采样，用于续传或按需提供片段\n");
+        printf(" --pass <秒>       过境调度模式下可用的发送时长\n");
+        printf(" --min-mode <模式>  过境调度模式下允许的最低画质模式，默认不限\n");
+        printf(" --stats [text|json]  结束时打印各阶段耗时与计数\n");
+        printf(" --headroom <dB>   多载波混合输出的峰值余量，默认 %.1f dB\n", headroom_db);
+        printf(" --soft-clip       多载波混合过载时使用软限幅\n");
+        printf(" --queue <N>       守护进程的任务队列深度，队列满时回复 BUSY，默认 4\n");
+        printf(" --cache <目录>    按图像内容、模式与选项缓存单幅编码的输出，重复请求直接复制\n");
+        printf(" --cache-size <MB>  缓存容量上限，超出时淘汰最久未用的条目，默认 1024 MB\n");
+        printf(" --incremental <状态文件>  只合成与上次相比变化的扫描线，其余由状态文件保存的正交分量旋转拼接\n");
+        printf("播放列表每行为 <图像文件名> <调制模式>，以 # 开头的行为注释；批量编码时每幅图像输出为 目录/序号_图像名。\n");
+        printf("调度队列每行为 <图像文件名> [最低模式]，按优先级从高到低排列。\n");
+        printf("混合列表每行为 <图像文件名> <调制模式> <频率偏移Hz> [增益] [起始毫秒] [初始相位度]。\n");
         printf("注意: 确保输入带有连字符的正确的调制模式名。\n");
         return 1;
     }
 
+    // 两种用法的输出文件名均为第三个参数
+    int playlist = strcmp(argv[1], "--playlist") == 0;
+    int mix = strcmp(argv[1], "--mix") == 0;
+    int schedule = strcmp(argv[1], "--schedule") == 0;
+    int batch = strcmp(argv[1], "--batch") == 0;
     filename = argv[3];
 
+    // 解析可选参数
+    for (int i = plan || serve ? 3 : 4; i < argc; i++) {
+        if (strcmp(argv[i], "--no-end") == 0) {
+            end_tones = 0;
+        } else if (strcmp(argv[i], "--fskid") == 0 && i + 1 < argc) {
+            fsk_id = argv[++i];
+        } else if (strcmp(argv[i], "--gap") == 0 && i + 1 < argc) {
+            gap_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            sample_rate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "pcm16") == 0) {
+                sample_format = WAV_PCM16;
+            } else if (strcmp(argv[i], "pcm24") == 0) {
+                sample_format = WAV_PCM24;
+            } else if (strcmp(argv[i], "float32") == 0) {
+                sample_format = WAV_FLOAT32;
+            } else if (strcmp(argv[i], "flac") == 0) {
+                sample_format = WAV_FLAC;
+            } else {
+                printf("不支持的采样格式: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rf64") == 0) {
+            force_rf64 = 1;
+        } else if (strcmp(argv[i], "--iq") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "cf32") == 0) {
+                iq_format = IQ_CF32;
+            } else if (strcmp(argv[i], "cs16") == 0) {
+                iq_format = IQ_CS16;
+            } else {
+                printf("不支持的 I/Q 格式: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--iq-offset") == 0 && i + 1 < argc) {
+            iq_offset = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--fm") == 0 && i + 1 < argc) {
+            fm_deviation = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--fm-rate") == 0 && i + 1 < argc) {
+            fm_rate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            mmap_io = 1;
+        } else if (strcmp(argv[i], "--raw") == 0 && i + 2 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &raw_width, &raw_height) != 2 || raw_width <= 0 || raw_height <= 0) {
+                printf("裸帧尺寸格式错误: %s\n", argv[i]);
+                return -1;
+            }
+            raw_format = Pixel_Format(argv[++i]);
+            if (raw_format < 0) {
+                printf("不支持的裸帧格式: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--range") == 0 && i + 2 < argc) {
+            range_start = strtoull(argv[++i], NULL, 10);
+            range_end = strtoull(argv[++i], NULL, 10);
+            range = 1;
+        } else if (strcmp(argv[i], "--pass") == 0 && i + 1 < argc) {
+            pass_s = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-mode") == 0 && i + 1 < argc) {
+            min_mode = argv[++i];
+            if (!Valid_Model(min_mode)) {
+                printf("错误的调制模式: %s\n", min_mode);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats_enabled = 1;
+            if (i + 1 < argc && (strcmp(argv[i + 1], "json") == 0 || strcmp(argv[i + 1], "text") == 0)) {
+                stats_json = strcmp(argv[++i], "json") == 0;
+            }
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            cache_size_mb = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--incremental") == 0 && i + 1 < argc) {
+            line_state = argv[++i];
+        } else if (strcmp(argv[i], "--synth") == 0 && i + 1 < argc) {
+            synth_backend = Synth_Backend(argv[++i]);
+            if (synth_backend < 0) {
+                printf("不支持的合成后端: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--no-kernel") == 0) {
+            kernels_enabled = 0;
+        } else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            queue_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--headroom") == 0 && i + 1 < argc) {
+            headroom_db = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--soft-clip") == 0) {
+            soft_clip = 1;
+        } else {
+            printf("未知的参数: %s，请使用 ./sstv --help 获取帮助。\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (sample_rate < 8000) {
+        printf("采样率过低: %u Hz\n", sample_rate);
+        return -1;
+    }
+    if (fsk_id && !Valid_FSK_ID(fsk_id)) {
+        printf("FSK ID 仅支持大写字母、数字与常用符号: %s\n", fsk_id);
+        return -1;
+    }
+    if (Synth_Init() != 0) return -1;
+    if (fm_deviation > 0) {
+        if (!iq_format) iq_format = IQ_CF32;
+        if (FM_Initialization() != 0) return -1;
+    }
+    if (mix && iq_format) {
+        printf("多载波混合暂不支持 I/Q 输出。\n");
+        return -1;
+    }
+
+    if (range && (playlist || mix || schedule || batch || (iq_format && fm_deviation == 0))) {
+        printf("--range 仅支持单幅图像的音频或调频输出。\n");
+        return -1;
+    }
+    if (line_state && (playlist || mix || schedule || batch || serve || range || cache_dir || (iq_format && fm_deviation == 0))) {
+        printf("--incremental 仅支持单幅图像的音频或调频输出，且不与 --range、--cache 同时使用。\n");
+        return -1;
+    }
+    if (cache_dir && (playlist || mix || schedule || batch || range)) {
+        printf("--cache 仅用于单幅图像的编码与守护进程，不与播放列表、混合、调度、批量及 --range 同时使用。\n");
+        return -1;
+    }
+
+#ifdef SSTV_NO_STATS
+    if (stats_enabled) {
+        printf("性能计数已在编译时移除 (SSTV_NO_STATS)。\n");
+        stats_enabled = 0;
+    }
+#endif
+    if (stats_enabled) Stats_Start();
+    if (cache_dir && Cache_Init() != 0) return -1;
+
     // 调用预处理函数
-    return Preprocessing(argv[1], argv[2]);
+    int status;
+    if (plan) status = Plan_Print(argv[2]);
+    else if (serve) status = Daemon(argv[2]);
+    else if (range) status = Index_Output(argv[1], argv[2], range_start, range_end);
+    else if (line_state) status = Incremental_Encode(argv[1], argv[2]);
+    else if (playlist) status = Playlist(argv[2]);
+    else if (schedule) status = Schedule(argv[2]);
+    else if (batch) status = Batch(argv[2], argv[3]);
+    else if (mix) status = Mixer(argv[2]);
+    else status = Preprocessing(argv[1], argv[2]);
+
+    if (stats_enabled) Stats_Report(stats_json);
+    if (cache_dir && !serve) Cache_Report();
+
+    return status;
 }
 
 // 预处理函数
 int Preprocessing(char *image, char *model) {
 
-    // 读取图像
-    pixels = stbi_load(image, &width, &height, &channels, 3);
-    if (!pixels) {
-        printf("图像文件加载失败，请检查图像是否存在。\n");
+    if (!Valid_Model(model)) {
+        printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
         return -1;
     }
 
+    // 输出缓存：先解码并散列像素，命中时直接复制缓存的输出，不再调制
+    char key[64];
+    if (cache_dir) {
+        if (image) {
+            STATS_BEGIN(t);
+            int loaded = Image_Load(image);
+            STATS_END(STAGE_LOAD, t);
+            if (loaded != 0) return -1;
+        }
+        Cache_Key(model, key);
+        if (Cache_Fetch(key)) {
+            if (image) Image_Free();
+            Cache_Totals(model);
+            printf("End.\n");
+            return 0;
+        }
+    }
+
+    // 内存映射输出：总采样数只由模式时序决定，据此预分配输出文件
+    if (mmap_io) {
+        SSTV_Plan plan;
+        Plan_Mode(&plan, model, LEAD_SILENCE_MS * 1000000ULL);
+        planned_samples = Plan_Total_Samples(&plan);
+    }
+
     // 初始化 WAV 容器
-    WAV_Initialization();
+    if (WAV_Initialization() != 0) {
+        if (image && cache_dir) Image_Free();
+        return -1;
+    }
 
-    // 按模式选择 VIS 前导码并调用相关函数
-    if (strcmp(model, "Scottie-DX") == 0){
-        Generate_VIS("1001100");
-        Generate_Scottie_DX();
-    } else if (strcmp(model, "PD-120") == 0){
-        Generate_VIS("1011111");
-        Generate_PD_120();
-    } else if (strcmp(model, "Robot-36") == 0){
-        Generate_VIS("0001000");
-        Generate_Robot_36();
-    }else {
-	    printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
-	    return -1;
+    // image 为 NULL 时调制已由 Image_From_Buffer 引用的像素；使用缓存时图像已在上面加载
+    int status;
+    if (image && !cache_dir) {
+        status = Encode_Image(image, model);
+    } else {
+        status = Encode_Pixels(model);
+        if (image) Image_Free();
     }
-    
-    // 释放 WAV 容器
+
+    // 释放 WAV 容器，写出失败时不存入缓存
+    if (WAV_Finalization() != 0) status = -1;
+
+    if (status == 0 && cache_dir) Cache_Store(key);
+
+    return status;
+}
+
+// 播放列表：单一 WAV 容器内连续发送多幅图像，图像逐幅加载与释放，音频边生成边写出
+int Playlist(char *list) {
+    char **images, **models;
+
+    int count = Playlist_Read(list, &images, &models);
+    if (count < 0) return -1;
+
+    int status = Stream_Images(images, models, count);
+    Playlist_Free(images, models, count);
+
+    return status;
+}
+
+// 读入并校验播放列表的全部条目，避免发送到一半才发现错误；返回条目数，出错时返回 -1
+int Playlist_Read(char *list, char ***images_out, char ***models_out) {
+
+    FILE *fp = fopen(list, "r");
+    if (!fp) {
+        printf("播放列表打开失败: %s\n", list);
+        return -1;
+    }
+
+    char line[1024];
+    char **images = NULL, **models = NULL;
+    int count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = 0;
+        char *end = line + strlen(line);
+        while (end > line && (end[-1] == ' ' || end[-1] == '\t')) *--end = 0;
+        if (line[0] == 0 || line[0] == '#') continue;
+
+        // 最后一个空白分隔的字段为调制模式，其余为文件名（允许包含空格）
+        char *split = strrchr(line, ' ');
+        char *tab = strrchr(line, '\t');
+        if (tab > split) split = tab;
+        if (!split) {
+            printf("播放列表格式错误: %s\n", line);
+            fclose(fp);
+            Playlist_Free(images, models, count);
+            return -1;
+        }
+        *split = 0;
+        char *model = split + 1;
+        while (split > line && (split[-1] == ' ' || split[-1] == '\t')) *--split = 0;
+        if (!Valid_Model(model)) {
+            printf("播放列表中有错误的调制模式: %s\n", model);
+            fclose(fp);
+            Playlist_Free(images, models, count);
+            return -1;
+        }
+
+        images = realloc(images, (count + 1) * sizeof(char *));
+        models = realloc(models, (count + 1) * sizeof(char *));
+        images[count] = strdup(line);
+        models[count] = strdup(model);
+        count++;
+    }
+    fclose(fp);
+
+    if (count == 0) {
+        printf("播放列表为空: %s\n", list);
+        return -1;
+    }
+
+    *images_out = images;
+    *models_out = models;
+    return count;
+}
+
+// 释放播放列表条目
+void Playlist_Free(char **images, char **models, int count) {
+    for (int i = 0; i < count; i++) {
+        free(images[i]);
+        free(models[i]);
+    }
+    free(images);
+    free(models);
+}
+
+// 在一个音频流中依次发送多幅图像：整个流共用一次初始化与收尾，图像之间插入静默间隔，相位在图像内连续
+int Stream_Images(char **images, char **models, int count) {
+
+    // 内存映射输出：逐幅规划，得到整个列表的总采样数
+    if (mmap_io) {
+        SSTV_Plan plan;
+        uint64_t t = LEAD_SILENCE_MS * 1000000ULL;
+        for (int i = 0; i < count; i++) {
+            if (i > 0 && gap_ms > 0) t += Duration_NS(gap_ms);
+            Plan_Mode(&plan, models[i], t);
+            t = plan.end_ns;
+        }
+        planned_samples = Sample_At(t + LEAD_SILENCE_MS * 1000000ULL);
+    }
+
+    // 整个播放列表共用一次初始化与收尾；间隔为真正的静默，其后相位归零，下一幅的 VIS 与首幅一样由零值起始
+    if (WAV_Initialization() != 0) return -1;
+
+    int status = 0;
+    for (int i = 0; i < count && status == 0; i++) {
+        if (i > 0 && gap_ms > 0) {
+            WAV_Write(0, gap_ms);
+            phase_acc = 0;
+        }
+        printf("发送 %d/%d: %s (%s)\n", i + 1, count, images[i], models[i]);
+        status = Encode_Image(images[i], models[i]);
+    }
+
     WAV_Finalization();
 
+    return status;
+}
+
+// 判断调制模式名是否受支持
+int Valid_Model(char *model) {
+    return Find_Mode(model) != NULL;
+}
+
+// 判断呼号能否以 FSK ID 发送：字符以 0x20 为偏移编码，仅支持 6 位可表示的 0x20~0x5F
+int Valid_FSK_ID(char *callsign) {
+    for (char *c = callsign; *c; c++) {
+        if (*c < 0x20 || *c > 0x5F) return 0;
+    }
+
+    return 1;
+}
+
+// 按名称查找模式表
+const SSTV_Mode *Find_Mode(char *model) {
+    for (int i = 0; i < mode_count; i++) {
+        if (strcmp(model, modes[i].name) == 0) return &modes[i];
+    }
+
+    return NULL;
+}
+
+// 调制单幅图像：VIS 前导、图像数据与结束段
+int Encode_Image(char *image, char *model) {
+
+    // 读取图像
+    STATS_BEGIN(t);
+    int loaded = Image_Load(image);
+    STATS_END(STAGE_LOAD, t);
+    if (loaded != 0) return -1;
+
+    int status = Encode_Pixels(model);
+
     // 释放图像内存
-    stbi_image_free((unsigned char*)pixels);
+    Image_Free();
 
-    return 0;
+    return status;
+}
+
+// 调制已加载的图像，也可在 Image_From_Buffer 引用相机缓冲后直接调用
+int Encode_Pixels(char *model) {
+
+    // 按模式选择 VIS 前导码并调用相关函数
+    // 多线程时先只记录 VIS 与图像的音调时序，再并行合成
+    const SSTV_Mode *mode = Find_Mode(model);
+    if (mode && (width < mode->width || height < mode->height)) {
+        printf("图像尺寸 %dx%d 小于 %s 模式的分辨率 %dx%d。\n", width, height, mode->name, mode->width, mode->height);
+        return -1;
+    }
+    if (mode) {
+        int parallel = Parallel_Begin();
+        Generate_VIS(mode->vis);
+        if (Kernel_Usable()) mode->kernel();
+        else mode->generate();
+        if (parallel && Parallel_End() != 0) return -1;
+    }
+
+    // 结束段：结束音与 FSK ID
+    return Generate_Trailer();
 }
 
 // 调制 VIS 前导头
@@ -147,24 +605,122 @@ int Generate_End() {
     return 0;
 }
 
+// 调制 MMSSTV 格式的 FSK ID：每字符 6 位，低位在前，每位 22ms，1 为 1900Hz，0 为 2100Hz
+int Generate_FSK_ID(char *callsign) {
+
+    // 选项解析时已检查，这里防止其他调用者传入无法编码的字符
+    if (!Valid_FSK_ID(callsign)) {
+        printf("FSK ID 仅支持大写字母、数字与常用符号: %s\n", callsign);
+        return -1;
+    }
+
+    // 帧头 0x20 0x2A，随后为呼号，以 0x01 结束
+    int length = strlen(callsign);
+    for (int i = -2; i <= length; i++) {
+        int code = i == -2 ? 0x20 : i == -1 ? 0x2A : i == length ? 0x01 : callsign[i] - 0x20;
+        for (int bit = 0; bit < 6; bit++) {
+            WAV_Write((code >> bit) & 1 ? 1900 : 2100, 22);
+        }
+    }
+
+    return 0;
+}
+
+// 结束段：首次调用时渲染为缓存块，之后直接以当前相位重放。
+// 缓存以采样率、起点的亚采样位置、结束音与呼号为键，任一项变化（如时序校验切换采样率）时重新渲染
+int Generate_Trailer() {
+
+    if (!end_tones && !fsk_id) return 0;
+
+    uint64_t position = Block_Position(time_ns);
+    if (trailer_ready && (trailer_rate != sample_rate || trailer_position != position || trailer_end != end_tones
+                          || (trailer_fsk == NULL) != (fsk_id == NULL) || (fsk_id && strcmp(trailer_fsk, fsk_id) != 0))) {
+        WAV_Block_Free(&trailer);
+        free(trailer_fsk);
+        trailer_fsk = NULL;
+        trailer_ready = 0;
+    }
+
+    if (!trailer_ready) {
+        WAV_Block_Begin(&trailer);
+        int status = 0;
+        if (end_tones) status = Generate_End();
+        if (status == 0 && fsk_id) status = Generate_FSK_ID(fsk_id);
+        WAV_Block_End();
+        trailer_fsk = fsk_id ? strdup(fsk_id) : NULL;
+        if (status == 0 && fsk_id && !trailer_fsk) status = -1;
+        if (status != 0) {
+            WAV_Block_Free(&trailer);
+            free(trailer_fsk);
+            trailer_fsk = NULL;
+            return status;
+        }
+        trailer_rate = sample_rate;
+        trailer_position = position;
+        trailer_end = end_tones;
+        trailer_ready = 1;
+    }
+
+    return WAV_Write_Block(&trailer);
+}
+
 // 计算像素在某一颜色通道的强度
 double Channel_Value(char *channel, int x, int y) {
-    int index = (y * width + x) * 3;
+    double value = Channel_Lookup(channel, x, y);
+    if (synth_backend == SYNTH_LUT) value = floor(value + 0.5);
+
+    return value;
+}
+
+// 一段像素扫描：先求出整段的像素频率，再逐像素发送；next 与 row 不同时取两行均值。
+// 像素取值阶段每段只计时一次，逐像素读取周期计数器的开销会超过取值本身
+int Scan_Write(char *channel, int row, int next, int count, double duration_ms) {
+    double frequencies[count];
+
+    STATS_BEGIN(t);
+    for (int col = 0; col < count; col++) {
+        double value = next == row ? Channel_Value(channel, col, row)
+                                   : (Channel_Value(channel, col, row) + Channel_Value(channel, col, next)) / 2;
+        frequencies[col] = 1500 + value * COLOR_FREQ_MULT;
+    }
+    STATS_END(STAGE_PIXEL, t);
+
+    for (int col = 0; col < count; col++) {
+        if (WAV_Write(frequencies[col], duration_ms) != 0) return -1;
+    }
+
+    return 0;
+}
+
+// 由像素数据取得颜色通道的强度
+double Channel_Lookup(char *channel, int x, int y) {
+    unsigned char *pixel = pixels + (size_t)y * stride;
+    double R, G, B;
+
+    // 相机 YUV 输入直接取分量
+    if (pixel_format >= PIXEL_NV12) return YUV_Value(channel, x, y);
+
+    // 灰度图像三个通道相同
+    if (pixel_format == PIXEL_GRAY8) {
+        R = G = B = (double)pixel[x];
+    } else {
+        pixel += x * 3;
+        R = (double)pixel[0];
+        G = (double)pixel[1];
+        B = (double)pixel[2];
+    }
 
     // RGB 色彩模式
     if (strcmp(channel, "r") == 0) {
-        return (double)pixels[index];
+        return R;
     } else if (strcmp(channel, "g") == 0) {
-        return (double)pixels[index + 1];
+        return G;
     } else if (strcmp(channel, "b") == 0) {
-        return (double)pixels[index + 2];
+        return B;
     }
     
     // YRYB 色彩模式
     else {
-        double R = (double)pixels[index];
-        double G = (double)pixels[index + 1];
-        double B = (double)pixels[index + 2];
 
         if (strcmp(channel, "y") == 0) {
             return 16.0 + (.003906 * ((65.738 * R) + (129.057 * G) + (25.064 * B)));
@@ -174,6 +730,9 @@ double Channel_Value(char *channel, int x, int y) {
             return 128.0 + (.003906 * ((-37.945 * R) + (-74.494 * G) + (112.439 * B)));
         }
     }
+
+    // 未知通道名，调制函数中不会出现
+    return 0;
 }
 
 // Scottie-DX 模式
@@ -184,30 +743,26 @@ int Generate_Scottie_DX() {
 
     // 图像数据部分
     for(int row = 0; row < 256; row++) {
+        WAV_Line();
+
         // 分离脉冲
         WAV_Write(1500, 1.5);
 
         // 绿色扫描
-        for(int col = 0; col < 320; col++) {
-            WAV_Write(1500 + Channel_Value("g",col,row)*COLOR_FREQ_MULT, 1.08);
-        }
+        Scan_Write("g", row, row, 320, 1.08);
 
         // 分离脉冲
         WAV_Write(1500, 1.5);
 
         // 蓝色扫描
-        for(int col = 0; col < 320; col++) {
-            WAV_Write(1500 + Channel_Value("b",col,row)*COLOR_FREQ_MULT, 1.08);
-        }
+        Scan_Write("b", row, row, 320, 1.08);
 
         // 同步脉冲与同步沿
         WAV_Write(1200, 9);
         WAV_Write(1500, 1.5);
 
         // 红色扫描
-        for(int col = 0; col < 320; col++) {
-            WAV_Write(1500 + Channel_Value("r",col,row)*COLOR_FREQ_MULT, 1.08);
-        }
+        Scan_Write("r", row, row, 320, 1.08);
     }
 
     return 0;
@@ -221,6 +776,7 @@ int Generate_PD_120() {
 
         // PD 模式一次扫描两行，由偶数行开始
         if (row % 2 == 0) {
+            WAV_Line();
 
             // 长同步脉冲
             WAV_Write(1200, 20);
@@ -228,24 +784,16 @@ int Generate_PD_120() {
             WAV_Write(1500, 2.08);
 
             // 偶数行亮度扫描
-            for(int col = 0; col < 640; col++) {
-                WAV_Write(1500 + Channel_Value("y",col,row)*COLOR_FREQ_MULT, 0.19);
-            }
+            Scan_Write("y", row, row, 640, 0.19);
 
             // 两行RY均值扫描
-            for(int col = 0; col < 640; col++) {
-                WAV_Write(1500 + (Channel_Value("ry",col,row) + Channel_Value("ry",col,row+1)) / 2 *COLOR_FREQ_MULT, 0.19);
-            }
+            Scan_Write("ry", row, row+1, 640, 0.19);
 
             // 两行BY均值扫描
-            for(int col = 0; col < 640; col++) {
-                WAV_Write(1500 + (Channel_Value("by",col,row) + Channel_Value("by",col,row+1)) / 2 *COLOR_FREQ_MULT, 0.19);
-            }
+            Scan_Write("by", row, row+1, 640, 0.19);
 
             // 奇数行亮度扫描
-            for(int col = 0; col < 640; col++) {
-                WAV_Write(1500 + Channel_Value("y",col,row+1)*COLOR_FREQ_MULT, 0.19);
-            }
+            Scan_Write("y", row+1, row+1, 640, 0.19);
         }
     }
 
@@ -257,6 +805,7 @@ int Generate_Robot_36() {
 
     // Robot-36 模式共扫描 240 行
     for (int row = 0; row < 240; row++) {
+        WAV_Line();
 
         // 同步脉冲
         WAV_Write(1200, 9.0);
@@ -266,9 +815,7 @@ int Generate_Robot_36() {
         if (row % 2 == 0) {
 
             // 偶数行亮度扫描
-            for(int col = 0; col < 320; col++) {
-                WAV_Write(1500 + Channel_Value("y",col,row)*COLOR_FREQ_MULT, 0.275);
-            }
+            Scan_Write("y", row, row, 320, 0.275);
 
             //偶数分离脉冲
             WAV_Write(1500, 4.5);
@@ -276,25 +823,20 @@ int Generate_Robot_36() {
             WAV_Write(1900, 1.5);
 
             // 两行RY均值扫描
-            for(int col = 0; col < 320; col++) {
-                WAV_Write(1500 + (Channel_Value("ry",col,row) + Channel_Value("ry",col,row+1)) / 2 *COLOR_FREQ_MULT, 0.1375);
-            }
+            Scan_Write("ry", row, row+1, 320, 0.1375);
         } else {
 
             // 奇数行亮度扫描
-            for(int col = 0; col < 320; col++) {
-                WAV_Write(1500 + Channel_Value("y",col,row)*COLOR_FREQ_MULT, 0.275);
-            }
+            Scan_Write("y", row, row, 320, 0.275);
 
             //奇数分离脉冲
             WAV_Write(2300, 4.5);
             // Porch 脉冲
             WAV_Write(1900, 1.5);
 
-            // 两行bY均值扫描
-            for(int col = 0; col < 320; col++) {
-                WAV_Write(1500 + (Channel_Value("by",col,row) + Channel_Value("by",col,row+1)) / 2 *COLOR_FREQ_MULT, 0.1375);
-            }
+            // 两行bY均值扫描，末行没有下一行时取本行
+            int next = row + 1 < 240 ? row + 1 : row;
+            Scan_Write("by", row, next, 320, 0.1375);
         }
     }
 
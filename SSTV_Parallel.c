@@ -0,0 +1,300 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 15: Multi-threaded synthesis with prefix-sum tone phases
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define PARALLEL_WINDOW 262144             // 每轮并行合成的采样数
+#define PARALLEL_BLOCK 4096                // 交给输出级的采样块长度
+
+// 获取外部变量
+extern int thread_count;
+extern uint32_t sample_rate;
+extern int iq_format;
+extern double fm_deviation;
+extern Tone_List *capture;
+extern PCM_Block *recording;
+extern uint64_t phase_acc;
+
+// 结构体：一个线程负责的采样区间
+typedef struct {
+    SSTV_Index *index;        // 共享的只读时序索引
+    uint64_t a, b;            // 区间 [a, b)
+    double *out;              // 输出位置
+} Parallel_Task;
+
+// 结构体：一个线程负责的音调区间，用于分段求相位前缀和
+typedef struct {
+    SSTV_Index *index;        // 共享的时序索引
+    size_t first, last;       // 音调区间 [first, last)
+    uint64_t samples;         // 区间的总采样数；第二遍时为区间起点的采样序号
+    uint64_t phase;           // 区间的总相位推进；第二遍时为区间起点的相位
+    int pass;                 // 1 为求和，2 为写出起点
+} Parallel_Scan_Task;
+
+// 结构体：常驻的工作线程组，一次并行合成的前缀和两遍与各窗口共用，避免每轮创建线程
+typedef struct {
+    pthread_t *threads;       // 已启动的工作线程，第 k 个负责第 k + 1 路
+    int started;              // 已启动的工作线程数，创建失败时少于 count - 1
+    int count;                // 每轮的任务路数，第 0 路由调用线程执行
+    void *(*job)(void *);     // 本轮的任务函数
+    char *tasks;              // 本轮各路的任务参数
+    size_t task_size;         // 每路任务参数的字节数
+    uint64_t round;           // 轮次，递增时唤醒工作线程
+    int pending;              // 本轮尚未完成的工作线程数
+    int stop;                 // 为 1 时工作线程退出
+    pthread_mutex_t lock;
+    pthread_cond_t wake;      // 新一轮开始或退出
+    pthread_cond_t done;      // 本轮全部完成
+} Parallel_Pool;
+
+// 定义程序内全局变量
+Tone_List parallel_tones;     // 正在记录的音调时序
+int parallel_active;          // 是否处于并行记录中
+Parallel_Pool parallel_pool;  // 并行合成期间的工作线程组
+
+// 声明程序内函数
+int Parallel_Threads();
+int Parallel_Begin();
+int Parallel_End();
+int Parallel_Phases(SSTV_Index *, uint64_t *);
+void Parallel_Start(int);
+void Parallel_Run(void *(*)(void *), void *, size_t);
+void Parallel_Stop();
+void *Parallel_Pool_Worker(void *);
+void *Parallel_Worker(void *);
+void *Parallel_Scan_Worker(void *);
+
+// 工作线程数，0 表示按处理器数
+int Parallel_Threads() {
+    int threads = thread_count > 0 ? thread_count : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    return threads < 1 ? 1 : threads;
+}
+
+// 开始并行合成：之后的 WAV_Write 沿当前时间轴只记录音调时序；不满足条件时返回 0，照常逐音调合成
+// 复基带输出使用独立的合成路径，时序记录与缓存录制期间也不启用
+int Parallel_Begin() {
+    if (Parallel_Threads() < 2 || capture || recording || (iq_format && fm_deviation == 0)) return 0;
+
+    WAV_Capture_Continue(&parallel_tones);
+    parallel_active = 1;
+
+    return 1;
+}
+
+// 结束并行合成：先以并行前缀和求出每个音调的起始采样与起始相位，再把采样按窗口分给多个线程，
+// 每个线程直接写入窗口内的最终位置，窗口按顺序交给输出级。相位累加与表达式均与 WAV_Write 相同，结果逐位一致
+int Parallel_End() {
+    SSTV_Index index;
+
+    if (!parallel_active) return 0;
+    WAV_Capture_Keep();
+    parallel_active = 0;
+
+    memset(&index, 0, sizeof(SSTV_Index));
+    index.tones = parallel_tones;
+    index.sample_rate = sample_rate;
+    memset(&parallel_tones, 0, sizeof(Tone_List));
+    int threads = Parallel_Threads();
+    Parallel_Start(threads);
+    if (Parallel_Phases(&index, &phase_acc) != 0) {
+        Parallel_Stop();
+        Index_Free(&index);
+        return -1;
+    }
+    STATS_ADD(tones, index.tones.count);
+
+    double *window = malloc(PARALLEL_WINDOW * sizeof(double));
+    if (!window) {
+        printf("并行合成内存分配失败。\n");
+        Parallel_Stop();
+        Index_Free(&index);
+        return -1;
+    }
+    Parallel_Task tasks[threads];
+
+    uint64_t total = index.tones.total_samples;
+    for (uint64_t base = 0; base < total; base += PARALLEL_WINDOW) {
+        uint64_t length = total - base < PARALLEL_WINDOW ? total - base : PARALLEL_WINDOW;
+
+        // 窗口按采样数均分，各线程负载相同
+        STATS_BEGIN(t);
+        for (int k = 0; k < threads; k++) {
+            tasks[k].index = &index;
+            tasks[k].a = base + length * k / threads;
+            tasks[k].b = base + length * (k + 1) / threads;
+            tasks[k].out = window + (tasks[k].a - base);
+        }
+        Parallel_Run(Parallel_Worker, tasks, sizeof(Parallel_Task));
+        STATS_END(STAGE_SYNTH, t);
+
+        for (uint64_t done = 0; done < length; done += PARALLEL_BLOCK) {
+            uint32_t count = length - done < PARALLEL_BLOCK ? length - done : PARALLEL_BLOCK;
+            if (WAV_Write_Audio(window + done, count) != 0) {
+                Parallel_Stop();
+                free(window);
+                Index_Free(&index);
+                return -1;
+            }
+        }
+    }
+
+    Parallel_Stop();
+    free(window);
+    Index_Free(&index);
+
+    return 0;
+}
+
+// 并行求每个音调的起始采样与起始相位：各线程先对自己的音调段求和，串行累加各段总和得到段起点，
+// 各线程再从段起点写出段内每个音调的起点。整数加法满足结合律，分段方式不影响结果；须在 Parallel_Start 之后调用
+int Parallel_Phases(SSTV_Index *index, uint64_t *phase) {
+    if (Index_Alloc(index) != 0) return -1;
+
+    int threads = parallel_pool.count;
+    size_t count = index->tones.count;
+    Parallel_Scan_Task tasks[threads];
+
+    for (int pass = 1; pass <= 2; pass++) {
+        for (int k = 0; k < threads; k++) {
+            tasks[k].index = index;
+            tasks[k].first = count * k / threads;
+            tasks[k].last = count * (k + 1) / threads;
+            tasks[k].pass = pass;
+        }
+        Parallel_Run(Parallel_Scan_Worker, tasks, sizeof(Parallel_Scan_Task));
+
+        // 段总和的前缀和即各段的起点
+        if (pass == 1) {
+            uint64_t start = 0;
+            for (int k = 0; k < threads; k++) {
+                uint64_t samples = tasks[k].samples, advance = tasks[k].phase;
+                tasks[k].samples = start;
+                tasks[k].phase = *phase;
+                start += samples;
+                *phase += advance;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// 启动 count - 1 个常驻工作线程；创建失败时不再继续，缺少线程的各路由调用线程执行
+void Parallel_Start(int count) {
+    Parallel_Pool *pool = &parallel_pool;
+    memset(pool, 0, sizeof(Parallel_Pool));
+    pool->count = count;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->threads = count > 1 ? malloc((count - 1) * sizeof(pthread_t)) : NULL;
+    if (!pool->threads) return;
+    while (pool->started < count - 1) {
+        if (pthread_create(&pool->threads[pool->started], NULL, Parallel_Pool_Worker, (void *)(intptr_t)(pool->started + 1)) != 0) {
+            printf("无法创建合成线程，其余部分由主线程完成。\n");
+            break;
+        }
+        pool->started++;
+    }
+}
+
+// 执行一轮：tasks 为 count 路、每路 size 字节的任务参数，返回时各路均已完成
+void Parallel_Run(void *(*job)(void *), void *tasks, size_t size) {
+    Parallel_Pool *pool = &parallel_pool;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->tasks = tasks;
+    pool->task_size = size;
+    pool->pending = pool->started;
+    pool->round++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    job(tasks);
+    for (int k = pool->started + 1; k < pool->count; k++) job((char *)tasks + k * size);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// 通知工作线程退出并回收
+void Parallel_Stop() {
+    Parallel_Pool *pool = &parallel_pool;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int k = 0; k < pool->started; k++) pthread_join(pool->threads[k], NULL);
+
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+    memset(pool, 0, sizeof(Parallel_Pool));
+}
+
+// 常驻工作线程：每轮执行第 k 路任务，直到收到退出通知
+void *Parallel_Pool_Worker(void *arg) {
+    Parallel_Pool *pool = &parallel_pool;
+    int k = (intptr_t)arg;
+    uint64_t seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->round == seen) pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->round;
+        void *(*job)(void *) = pool->job;
+        void *task = pool->tasks + k * pool->task_size;
+        pthread_mutex_unlock(&pool->lock);
+
+        job(task);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// 前缀和工作线程：第一遍求段总和，第二遍写出段内各音调的起点
+void *Parallel_Scan_Worker(void *arg) {
+    Parallel_Scan_Task *task = arg;
+    if (task->pass == 1) Index_Sum(task->index, task->first, task->last, &task->samples, &task->phase);
+    else Index_Scan(task->index, task->first, task->last, task->samples, task->phase);
+
+    return NULL;
+}
+
+// 工作线程：生成自己的区间
+void *Parallel_Worker(void *arg) {
+    Parallel_Task *task = arg;
+    Index_Render(task->index, task->a, task->b, task->out);
+
+    return NULL;
+}
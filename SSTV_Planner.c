@@ -0,0 +1,241 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 11: Closed-form transmission planner and timing verification
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define VIS_NS 1710000000ULL               // VIS 前导：前导音 800ms、引导音 640ms、7 位数据与校验、结束位各 30ms
+#define END_TONES_NS 900000000ULL          // 结束音 500ms 与 4 个 100ms 的交替音
+#define FSK_BIT_NS 22000000ULL             // FSK ID 每位 22ms
+#define SLANT_LIMIT_PPM 1.0                // 校验时允许的行周期偏差
+
+// 获取外部变量
+extern uint32_t sample_rate;
+extern int end_tones;
+extern char *fsk_id;
+extern uint64_t time_ns;
+extern uint64_t timeline_samples;
+extern int kernels_enabled;
+extern const SSTV_Mode modes[];
+extern const int mode_count;
+
+// 声明程序内函数
+int Plan_Mode(SSTV_Plan *, char *, uint64_t);
+uint64_t Plan_Trailer_NS();
+uint64_t Plan_Line_Start(SSTV_Plan *, size_t);
+uint64_t Plan_Total_Samples(SSTV_Plan *);
+int Plan_Print(char *);
+int Timing_Verify(char *);
+int Timing_Check(const SSTV_Mode *, uint32_t);
+int Trailer_Check(Tone_List *, SSTV_Plan *);
+
+// 规划一次发送：VIS 前导、图像与结束段从时间轴上的 start_ns 开始
+// 音调边界由累计时间决定，所有时刻与采样序号都能以常数时间算出，与实际生成的结果逐采样一致
+int Plan_Mode(SSTV_Plan *plan, char *model, uint64_t start_ns) {
+    const SSTV_Mode *mode = Find_Mode(model);
+    if (!mode) return -1;
+
+    memset(plan, 0, sizeof(SSTV_Plan));
+    plan->mode = mode;
+    plan->sample_rate = sample_rate;
+    plan->start_ns = start_ns;
+    plan->image_ns = start_ns + VIS_NS + mode->start_ns;
+    plan->trailer_ns = plan->image_ns + mode->lines * mode->line_ns;
+    plan->end_ns = plan->trailer_ns + Plan_Trailer_NS();
+    plan->start_sample = Sample_At(start_ns);
+    plan->end_sample = Sample_At(plan->end_ns);
+
+    return 0;
+}
+
+// 结束段时长：FSK ID 由帧头 2 字符、呼号与结束符组成，每字符 6 位
+uint64_t Plan_Trailer_NS() {
+    uint64_t ns = end_tones ? END_TONES_NS : 0;
+    if (fsk_id) ns += (strlen(fsk_id) + 3) * 6 * FSK_BIT_NS;
+
+    return ns;
+}
+
+// 第 line 条扫描线（WAV_Line 标记的位置）在整个流中的起始采样
+uint64_t Plan_Line_Start(SSTV_Plan *plan, size_t line) {
+    return Sample_At(plan->image_ns + line * plan->mode->line_ns);
+}
+
+// 单独发送（含首尾静音）时的总采样数；结束段的缓存块与时间轴的差异由尾部静音吸收
+uint64_t Plan_Total_Samples(SSTV_Plan *plan) {
+    return Sample_At(plan->end_ns + LEAD_SILENCE_MS * 1000000ULL);
+}
+
+// 打印单独发送一幅图像的规划
+int Plan_Print(char *model) {
+    SSTV_Plan plan;
+    if (Plan_Mode(&plan, model, LEAD_SILENCE_MS * 1000000ULL) != 0) {
+        printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
+        return -1;
+    }
+
+    uint64_t total = Plan_Total_Samples(&plan);
+    printf("%s: %dx%d，%d 条扫描线，每条 %.4f 毫秒\n", model, plan.mode->width, plan.mode->height,
+           plan.mode->lines, plan.mode->line_ns / 1e6);
+    printf("总时长 %.6f 秒，共 %llu 个采样 (%u Hz)\n", total / (double)sample_rate,
+           (unsigned long long)total, sample_rate);
+    printf("图像起始于采样 %llu，结束段起始于采样 %llu\n", (unsigned long long)Plan_Line_Start(&plan, 0),
+           (unsigned long long)Sample_At(plan.trailer_ns));
+
+    return 0;
+}
+
+// 时序校验：实际生成各模式的音调时序（只记录不合成），逐行比较扫描线起点与理想时刻
+// 对全部模式与常用采样率各运行一次，耗时不到一秒，可在每次构建后运行
+int Timing_Verify(char *model) {
+    static const uint32_t rates[] = {8000, 11025, 22050, 44100, 48000, 96000, 192000};
+    uint32_t saved_rate = sample_rate;
+    int failed = 0;
+
+    if (model && !Find_Mode(model)) {
+        printf("错误的调制模式，请使用 ./sstv --help 获取帮助。\n");
+        return -1;
+    }
+
+    printf("模式         采样率   最大偏移(采样)  行周期偏差(ppm)  单行抖动(ppm)  总采样数\n");
+    for (int m = 0; m < mode_count; m++) {
+        if (model && strcmp(model, modes[m].name) != 0) continue;
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            sample_rate = rates[r];
+            failed |= Timing_Check(&modes[m], rates[r]);
+        }
+    }
+    sample_rate = saved_rate;
+
+    printf(failed ? "时序校验失败。\n" : "时序校验通过。\n");
+
+    return failed;
+}
+
+// 校验单个模式：偏移为实际起点减理想起点，行周期偏差为实际起点对理想起点最小二乘拟合的斜率误差（即图像倾斜），
+// 单行抖动为相邻两行采样数相对理想行周期的最大偏差，由整数采样的量化造成，不累积
+int Timing_Check(const SSTV_Mode *mode, uint32_t rate) {
+    SSTV_Plan plan;
+    Tone_List list, generic;
+
+    // 以确定的渐变与纹理图像生成时序：时序与像素内容无关，像素频率则用于比较两条路径的取值表达式
+    unsigned char *image = malloc((size_t)mode->width * mode->height * 3);
+    if (!image) {
+        printf("时序校验内存分配失败。\n");
+        return 1;
+    }
+    for (int y = 0; y < mode->height; y++) {
+        for (int x = 0; x < mode->width; x++) {
+            unsigned char *pixel = image + ((size_t)y * mode->width + x) * 3;
+            pixel[0] = x * 255 / mode->width;
+            pixel[1] = y * 255 / mode->height;
+            pixel[2] = (x * 7 + y * 13) & 0xFF;
+        }
+    }
+    Image_From_Buffer(image, mode->width, mode->height, mode->width * 3, PIXEL_RGB24);
+    WAV_Capture_Begin(&list);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    int status = Encode_Pixels(mode->name);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    WAV_Capture_End();
+
+    // 通用的 Generate_* 路径须记录到逐音调相同的时序
+    int enabled = kernels_enabled;
+    kernels_enabled = 0;
+    WAV_Capture_Begin(&generic);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    if (status == 0) status = Encode_Pixels(mode->name);
+    WAV_Write(0, LEAD_SILENCE_MS);
+    WAV_Capture_End();
+    kernels_enabled = enabled;
+    int kernel_failed = kernels_enabled && !Tone_Same(&list, &generic);
+    Tone_Free(&generic);
+    Image_Free();
+    free(image);
+
+    Plan_Mode(&plan, mode->name, LEAD_SILENCE_MS * 1000000ULL);
+    if (status != 0 || list.line_count != (size_t)mode->lines) {
+        printf("%-12s %6u  扫描线数 %zu 与模式表的 %d 不符\n", mode->name, rate, list.line_count, mode->lines);
+        Tone_Free(&list);
+        return 1;
+    }
+
+    // 逐行累计实际起点，与理想起点 (image_ns + k·line_ns)·rate 比较
+    double ideal_period = mode->line_ns * 1e-9 * rate;
+    double max_offset = 0, max_jitter = 0;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    uint64_t start = 0, previous = 0;
+    size_t tone = 0;
+    for (size_t k = 0; k < list.line_count; k++) {
+        for (; tone < list.lines[k]; tone++) start += list.tones[tone].num_samples;
+        double ideal = (plan.image_ns + k * mode->line_ns) * 1e-9 * rate;
+        double offset = start - ideal;
+        if (fabs(offset) > max_offset) max_offset = fabs(offset);
+        if (k > 0) {
+            double jitter = fabs((start - previous) / ideal_period - 1) * 1e6;
+            if (jitter > max_jitter) max_jitter = jitter;
+        }
+        sx += k;
+        sy += offset;
+        sxx += (double)k * k;
+        sxy += k * offset;
+        previous = start;
+    }
+    double n = list.line_count;
+    double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    double slant_ppm = slope / ideal_period * 1e6;
+
+    int trailer_failed = Trailer_Check(&list, &plan);
+    int failed = max_offset >= 1.0 || fabs(slant_ppm) > SLANT_LIMIT_PPM || list.total_samples != Plan_Total_Samples(&plan)
+                 || trailer_failed || kernel_failed;
+    printf("%-12s %6u  %14.3f  %15.4f  %13.1f  %llu%s%s%s\n", mode->name, rate, max_offset, slant_ppm, max_jitter,
+           (unsigned long long)list.total_samples, trailer_failed ? "  结束段音调边界不符" : "",
+           kernel_failed ? "  专用函数与 Generate_* 的音调时序不符" : "", failed ? "  失败" : "");
+    Tone_Free(&list);
+
+    return failed;
+}
+
+// 校验结束段：从计划的结束段起点不经缓存块直接生成结束音与 FSK ID 的音调时序，
+// 实际发送中（经缓存块重放）结束段的起点与各音调的采样数须与之逐一相同；不符时返回 1
+int Trailer_Check(Tone_List *list, SSTV_Plan *plan) {
+    if (!end_tones && !fsk_id) return 0;
+
+    Tone_List reference;
+    WAV_Capture_Begin(&reference);
+    time_ns = plan->trailer_ns;
+    timeline_samples = Sample_At(time_ns);
+    int status = end_tones ? Generate_End() : 0;
+    if (status == 0 && fsk_id) status = Generate_FSK_ID(fsk_id);
+    WAV_Capture_End();
+
+    // 定位实际时序中结束段的首个音调
+    uint64_t start = 0, trailer_start = Sample_At(plan->trailer_ns);
+    size_t first = 0;
+    while (first < list->count && start < trailer_start) start += list->tones[first++].num_samples;
+    int failed = status != 0 || start != trailer_start || first + reference.count > list->count;
+    for (size_t k = 0; !failed && k < reference.count; k++) {
+        failed = list->tones[first + k].frequency != reference.tones[k].frequency
+                 || list->tones[first + k].num_samples != reference.tones[k].num_samples;
+    }
+    Tone_Free(&reference);
+
+    return failed;
+}
@@ -0,0 +1,216 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 12: Pass-window scheduling of images and modes
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 获取外部变量
+extern const SSTV_Mode modes[];
+extern const int mode_count;
+extern double gap_ms;
+
+// 定义程序内全局变量
+double pass_s;                // 过境可用的发送时长 (秒)
+char *min_mode;               // 允许的最低画质模式，为空时不限
+
+// 声明程序内函数
+int Schedule(char *);
+uint64_t Mode_Cost(const SSTV_Mode *);
+int Fit_Count(uint64_t *, int, int64_t, uint64_t *);
+int Mode_Allowed(const SSTV_Mode *, int);
+
+// 过境调度：在给定时长内按优先级发送尽可能多的图像，剩余时间用于提高画质，随后作为一个连续流发送
+// 调度分三步：
+//   1. 每幅图像取允许范围内最短的模式，求最多可发送的图像数 K（取代价最小的 K 幅）；
+//   2. 按优先级依次考察图像，只要加入后仍能凑满 K 幅就选中，使选中的图像在数量最多的前提下优先级最高；
+//   3. 按优先级把选中的图像升级到剩余时间允许的最高画质模式。
+// 发送顺序即优先级顺序，过境提前结束时损失的是优先级最低的图像
+int Schedule(char *queue) {
+    if (pass_s <= 0) {
+        printf("过境调度需要以 --pass 指定可用时长。\n");
+        return -1;
+    }
+    int floor_quality = min_mode ? Find_Mode(min_mode)->quality : 0;
+
+    FILE *fp = fopen(queue, "r");
+    if (!fp) {
+        printf("调度队列打开失败: %s\n", queue);
+        return -1;
+    }
+
+    // 读入队列：每行为图像文件名，末尾可附加该图像允许的最低模式
+    char line[1024];
+    char **images = NULL;
+    int *floors = NULL;
+    int count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = 0;
+        char *end = line + strlen(line);
+        while (end > line && (end[-1] == ' ' || end[-1] == '\t')) *--end = 0;
+        if (line[0] == 0 || line[0] == '#') continue;
+
+        int quality = floor_quality;
+        char *split = strrchr(line, ' ');
+        char *tab = strrchr(line, '\t');
+        if (tab > split) split = tab;
+        if (split && Valid_Model(split + 1)) {
+            const SSTV_Mode *mode = Find_Mode(split + 1);
+            if (mode->quality > quality) quality = mode->quality;
+            *split = 0;
+            while (split > line && (split[-1] == ' ' || split[-1] == '\t')) *--split = 0;
+        }
+
+        images = realloc(images, (count + 1) * sizeof(char *));
+        floors = realloc(floors, (count + 1) * sizeof(int));
+        images[count] = strdup(line);
+        floors[count] = quality;
+        count++;
+    }
+    fclose(fp);
+
+    if (count == 0) {
+        printf("调度队列为空: %s\n", queue);
+        return -1;
+    }
+
+    // 可用时长扣除首尾静音；每幅图像的代价含一个间隔，预算相应多算一个间隔
+    uint64_t gap_ns = gap_ms > 0 ? Duration_NS(gap_ms) : 0;
+    uint64_t pass_ns = Duration_NS(pass_s * 1000);
+    int64_t budget = (int64_t)pass_ns - 2 * LEAD_SILENCE_MS * 1000000LL + (int64_t)gap_ns;
+
+    // 每幅图像允许的最短模式
+    const SSTV_Mode **chosen = calloc(count, sizeof(SSTV_Mode *));
+    uint64_t *cheapest = malloc(count * sizeof(uint64_t));
+    for (int i = 0; i < count; i++) {
+        cheapest[i] = UINT64_MAX;
+        for (int m = 0; m < mode_count; m++) {
+            if (Mode_Allowed(&modes[m], floors[i]) && Mode_Cost(&modes[m]) + gap_ns < cheapest[i]) {
+                cheapest[i] = Mode_Cost(&modes[m]) + gap_ns;
+            }
+        }
+    }
+
+    // 第一步：最多可发送的图像数
+    uint64_t *sorted = malloc(count * sizeof(uint64_t));
+    int target = Fit_Count(cheapest, count, budget, sorted);
+
+    // 第二步：按优先级选择；选中第 i 幅后，其后图像中最短的若干幅须能补足剩余数量
+    int selected = 0;
+    int64_t left = budget;
+    for (int i = 0; i < count && selected < target; i++) {
+        if (cheapest[i] == UINT64_MAX || (int64_t)cheapest[i] > left) continue;
+        int64_t rest = left - (int64_t)cheapest[i];
+        if (Fit_Count(cheapest + i + 1, count - i - 1, rest, sorted) < target - selected - 1) continue;
+
+        for (int m = 0; m < mode_count; m++) {
+            if (Mode_Allowed(&modes[m], floors[i]) && Mode_Cost(&modes[m]) + gap_ns == cheapest[i]) {
+                chosen[i] = &modes[m];
+                break;
+            }
+        }
+        left = rest;
+        selected++;
+    }
+
+    // 第三步：按优先级升级画质，取剩余时间内可容纳的最高画质模式，画质相同时取较短者
+    for (int i = 0; i < count; i++) {
+        if (!chosen[i]) continue;
+        const SSTV_Mode *best = chosen[i];
+        for (int m = 0; m < mode_count; m++) {
+            int64_t extra = (int64_t)Mode_Cost(&modes[m]) - (int64_t)Mode_Cost(chosen[i]);
+            if (extra > left) continue;
+            if (modes[m].quality > best->quality || (modes[m].quality == best->quality && Mode_Cost(&modes[m]) < Mode_Cost(best))) {
+                best = &modes[m];
+            }
+        }
+        left -= (int64_t)Mode_Cost(best) - (int64_t)Mode_Cost(chosen[i]);
+        chosen[i] = best;
+    }
+
+    // 打印调度结果并整理发送列表
+    char **send_images = malloc(count * sizeof(char *));
+    char **send_models = malloc(count * sizeof(char *));
+    int sends = 0;
+    uint64_t t = LEAD_SILENCE_MS * 1000000ULL;
+    printf("过境时长 %.1f 秒，队列 %d 幅，可发送 %d 幅:\n", pass_s, count, selected);
+    for (int i = 0; i < count; i++) {
+        if (!chosen[i]) {
+            printf("  跳过      %s\n", images[i]);
+            continue;
+        }
+        SSTV_Plan plan;
+        if (sends > 0) t += gap_ns;
+        Plan_Mode(&plan, chosen[i]->name, t);
+        printf("  %8.1f 秒 %-10s %s\n", t / 1e9, chosen[i]->name, images[i]);
+        t = plan.end_ns;
+        send_images[sends] = images[i];
+        send_models[sends] = chosen[i]->name;
+        sends++;
+    }
+    t += LEAD_SILENCE_MS * 1000000ULL;
+    printf("合计 %.1f 秒，余量 %.1f 秒\n", t / 1e9, ((int64_t)pass_ns - (int64_t)t) / 1e9);
+
+    int status = sends > 0 ? Stream_Images(send_images, send_models, sends) : -1;
+    if (sends == 0) printf("过境时长内无法发送任何图像。\n");
+
+    for (int i = 0; i < count; i++) free(images[i]);
+    free(images);
+    free(floors);
+    free(chosen);
+    free(cheapest);
+    free(sorted);
+    free(send_images);
+    free(send_models);
+
+    return status;
+}
+
+// 一次发送（VIS、图像与结束段）的时长，与图像内容无关
+uint64_t Mode_Cost(const SSTV_Mode *mode) {
+    SSTV_Plan plan;
+    Plan_Mode(&plan, mode->name, 0);
+
+    return plan.end_ns - plan.start_ns;
+}
+
+// 在预算内最多能容纳的条目数：按代价从小到大装入，work 为长度不小于 count 的临时数组
+int Fit_Count(uint64_t *costs, int count, int64_t budget, uint64_t *work) {
+    memcpy(work, costs, count * sizeof(uint64_t));
+    for (int i = 1; i < count; i++) {
+        uint64_t key = work[i];
+        int j = i - 1;
+        while (j >= 0 && work[j] > key) {
+            work[j + 1] = work[j];
+            j--;
+        }
+        work[j + 1] = key;
+    }
+
+    int fit = 0;
+    int64_t used = 0;
+    while (fit < count && work[fit] != UINT64_MAX && used + (int64_t)work[fit] <= budget) {
+        used += work[fit++];
+    }
+
+    return fit;
+}
+
+// 模式画质是否满足最低要求
+int Mode_Allowed(const SSTV_Mode *mode, int floor_quality) {
+    return mode->quality >= floor_quality;
+}
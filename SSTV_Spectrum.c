@@ -0,0 +1,385 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 14: Welch power spectral density, occupied bandwidth and adjacent-channel power
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define WELCH_SIZE 4096                    // 默认 FFT 点数
+#define READ_SAMPLES 8192                  // 每次从文件读入的采样数
+
+// 声明程序内函数
+int Spectrum_Main(int, char **);
+int Spectrum_File(char *, int, double, double);
+int WAV_Read_Format(FILE *, uint32_t *, int *, int *, int *, uint64_t *);
+int Welch_Init(Welch_State *, int);
+void Welch_Process(Welch_State *, double *, uint32_t);
+void Welch_Free(Welch_State *);
+void Welch_Segment(Welch_State *);
+void FFT_Complex(Welch_State *, double *);
+double Band_Power(double *, int, double, double, double);
+void Occupied_Bandwidth(double *, int, double, double, double *, double *);
+double Spectrum_Now();
+
+// 频谱分析入口：./sstv --analyze <文件...> [--fft N] [--channel 下限Hz 上限Hz]
+// 可同时给出多个文件，便于比较不同合成方式的频谱
+int Spectrum_Main(int argc, char **argv) {
+    int size = WELCH_SIZE;
+    double low = 1000, high = 2500;
+    int files = 0, status = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--fft") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--channel") == 0 && i + 2 < argc) {
+            low = atof(argv[++i]);
+            high = atof(argv[++i]);
+        }
+    }
+    if (size < 64 || (size & (size - 1)) != 0) {
+        printf("FFT 点数须为不小于 64 的 2 的幂: %d\n", size);
+        return -1;
+    }
+    if (high <= low) {
+        printf("信道范围错误: %.1f ~ %.1f Hz\n", low, high);
+        return -1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--fft") == 0) {
+            i++;
+        } else if (strcmp(argv[i], "--channel") == 0) {
+            i += 2;
+        } else {
+            status |= Spectrum_File(argv[i], size, low, high);
+            files++;
+        }
+    }
+    if (files == 0) {
+        printf("用法: ./sstv --analyze <WAV 文件...> [--fft N] [--channel 下限Hz 上限Hz]\n");
+        return -1;
+    }
+
+    return status;
+}
+
+// 分析单个 WAV 文件：流式读入，逐段加窗 FFT 并平均功率谱
+int Spectrum_File(char *path, int size, double low, double high) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        printf("无法打开文件: %s\n", path);
+        return -1;
+    }
+
+    uint32_t rate;
+    int format, bits, channels;
+    uint64_t data_size;
+    if (WAV_Read_Format(fp, &rate, &format, &bits, &channels, &data_size) != 0) {
+        printf("不支持的 WAV 文件: %s\n", path);
+        fclose(fp);
+        return -1;
+    }
+
+    Welch_State welch;
+    if (Welch_Init(&welch, size) != 0) {
+        fclose(fp);
+        return -1;
+    }
+
+    // 多声道文件只分析第一个声道
+    int bytes = bits / 8;
+    int frame = bytes * channels;
+    uint8_t *raw = malloc((size_t)READ_SAMPLES * frame);
+    double *audio = malloc(READ_SAMPLES * sizeof(double));
+    uint64_t remaining = data_size / frame, total = 0;
+    double start = Spectrum_Now();
+    while (remaining > 0) {
+        size_t want = remaining < READ_SAMPLES ? remaining : READ_SAMPLES;
+        size_t got = fread(raw, frame, want, fp);
+        if (got == 0) break;
+        for (size_t i = 0; i < got; i++) {
+            uint8_t *p = raw + i * frame;
+            if (format == 3 && bits == 32) {
+                float value;
+                memcpy(&value, p, 4);
+                audio[i] = value;
+            } else if (bits == 16) {
+                audio[i] = (int16_t)(p[0] | p[1] << 8) / 32768.0;
+            } else if (bits == 24) {
+                audio[i] = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) / 2147483648.0;
+            } else if (bits == 32) {
+                int32_t value;
+                memcpy(&value, p, 4);
+                audio[i] = value / 2147483648.0;
+            } else {
+                audio[i] = (p[0] - 128) / 128.0;
+            }
+        }
+        Welch_Process(&welch, audio, got);
+        remaining -= got;
+        total += got;
+    }
+    double elapsed = Spectrum_Now() - start;
+    free(raw);
+    free(audio);
+    fclose(fp);
+
+    if (welch.segments == 0) {
+        printf("%s: 采样数少于一段 FFT (%d 点)。\n", path, size);
+        Welch_Free(&welch);
+        return -1;
+    }
+
+    // 平均后的单边功率谱，峰值归一化为 0 dBc
+    int bins = size / 2 + 1;
+    double resolution = (double)rate / size;
+    double peak = 0;
+    int peak_bin = 0;
+    for (int k = 0; k < bins; k++) {
+        welch.psd[k] /= welch.segments;
+        if (welch.psd[k] > peak) {
+            peak = welch.psd[k];
+            peak_bin = k;
+        }
+    }
+
+    printf("%s: %u Hz，%llu 个采样，FFT %d 点（分辨率 %.2f Hz），%llu 段\n", path, rate,
+           (unsigned long long)total, size, resolution, (unsigned long long)welch.segments);
+    printf("  峰值频率 %.1f Hz\n", peak_bin * resolution);
+    static const double levels[] = {30, 40, 60};
+    for (int i = 0; i < 3; i++) {
+        double lo, hi;
+        Occupied_Bandwidth(welch.psd, bins, resolution, peak * pow(10, -levels[i] / 10), &lo, &hi);
+        printf("  -%.0f dBc 占用带宽 %8.1f Hz (%.1f ~ %.1f Hz)\n", levels[i], hi - lo, lo, hi);
+    }
+
+    // 99% 功率带宽：两侧各去掉 0.5% 的功率
+    double sum = 0, acc = 0, lo99 = 0, hi99 = 0;
+    for (int k = 0; k < bins; k++) sum += welch.psd[k];
+    for (int k = 0; k < bins; k++) {
+        if (acc < 0.005 * sum && acc + welch.psd[k] >= 0.005 * sum) lo99 = k * resolution;
+        if (acc < 0.995 * sum && acc + welch.psd[k] >= 0.995 * sum) hi99 = k * resolution;
+        acc += welch.psd[k];
+    }
+    printf("  99%% 功率带宽   %8.1f Hz (%.1f ~ %.1f Hz)\n", hi99 - lo99, lo99, hi99);
+
+    // 邻道功率：与主信道等宽、紧邻两侧的信道相对主信道的功率
+    double width = high - low;
+    double main_power = Band_Power(welch.psd, bins, resolution, low, high);
+    double lower = Band_Power(welch.psd, bins, resolution, low - width, low);
+    double upper = Band_Power(welch.psd, bins, resolution, high, high + width);
+    printf("  邻道功率（信道 %.0f ~ %.0f Hz）: 下邻道 %.1f dBc，上邻道 %.1f dBc\n", low, high,
+           lower > 0 ? 10 * log10(lower / main_power) : -INFINITY, upper > 0 ? 10 * log10(upper / main_power) : -INFINITY);
+    printf("  分析耗时 %.3f 秒，%.0f 倍实时\n", elapsed, elapsed > 0 ? total / (double)rate / elapsed : 0);
+
+    Welch_Free(&welch);
+
+    return 0;
+}
+
+// 解析 WAV/RF64 文件头，文件指针停在 data 块的起点；写入中断的文件（长度为最大值）读到文件末尾为止
+int WAV_Read_Format(FILE *fp, uint32_t *rate, int *format, int *bits, int *channels, uint64_t *data_size) {
+    uint8_t head[12], chunk[8], fmt[40];
+    uint64_t ds64_data = UINT64_MAX;
+    int have_fmt = 0;
+
+    if (fread(head, 1, 12, fp) != 12 || (memcmp(head, "RIFF", 4) != 0 && memcmp(head, "RF64", 4) != 0)
+        || memcmp(head + 8, "WAVE", 4) != 0) {
+        return -1;
+    }
+
+    while (fread(chunk, 1, 8, fp) == 8) {
+        uint32_t length = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            size_t want = length < sizeof(fmt) ? length : sizeof(fmt);
+            if (want < 16 || fread(fmt, 1, want, fp) != want) return -1;
+            fseek(fp, length - want + (length & 1), SEEK_CUR);
+            *format = fmt[0] | fmt[1] << 8;
+            *channels = fmt[2] | fmt[3] << 8;
+            *rate = fmt[4] | fmt[5] << 8 | fmt[6] << 16 | (uint32_t)fmt[7] << 24;
+            *bits = fmt[14] | fmt[15] << 8;
+            if (*format == 0xFFFE && want >= 26) *format = fmt[24] | fmt[25] << 8;
+            have_fmt = 1;
+        } else if (memcmp(chunk, "ds64", 4) == 0) {
+            uint8_t ds64[28];
+            if (length < 16 || fread(ds64, 1, 16, fp) != 16) return -1;
+            ds64_data = 0;
+            for (int i = 7; i >= 0; i--) ds64_data = ds64_data << 8 | ds64[8 + i];
+            fseek(fp, length - 16, SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt || *channels < 1 || (*format != 1 && *format != 3)
+                || (*bits != 8 && *bits != 16 && *bits != 24 && *bits != 32)) {
+                return -1;
+            }
+            *data_size = length == UINT32_MAX ? (ds64_data != UINT64_MAX ? ds64_data : UINT64_MAX) : length;
+            return 0;
+        } else {
+            fseek(fp, length + (length & 1), SEEK_CUR);
+        }
+    }
+
+    return -1;
+}
+
+// 初始化 Welch 估计：四项 Blackman-Harris 窗（旁瓣 -92 dB，-60 dBc 的测量不受窗泄漏影响），段长 size，重叠一半；
+// 实数 FFT 以 size/2 点复数 FFT 实现
+int Welch_Init(Welch_State *welch, int size) {
+    memset(welch, 0, sizeof(Welch_State));
+    int half = size / 2;
+    welch->size = size;
+    welch->window = malloc(size * sizeof(double));
+    welch->ring = malloc(size * sizeof(double));
+    welch->psd = calloc(half + 1, sizeof(double));
+    welch->twiddle = malloc(size * sizeof(double));
+    welch->work = malloc(size * sizeof(double));
+    welch->reverse = malloc(half * sizeof(int));
+    if (!welch->window || !welch->ring || !welch->psd || !welch->twiddle || !welch->work || !welch->reverse) {
+        printf("频谱分析内存分配失败。\n");
+        Welch_Free(welch);
+        return -1;
+    }
+
+    // 窗函数与其能量，功率谱按窗能量归一化
+    double energy = 0;
+    for (int n = 0; n < size; n++) {
+        double x = 2 * PI * n / size;
+        welch->window[n] = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+        energy += welch->window[n] * welch->window[n];
+    }
+    welch->scale = 1.0 / energy;
+
+    // 旋转因子 e^(-2πik/size)，k < size/2，供复数 FFT（取偶数项）与实数拆分共用
+    for (int k = 0; k < half; k++) {
+        welch->twiddle[2 * k] = cos(2 * PI * k / size);
+        welch->twiddle[2 * k + 1] = -sin(2 * PI * k / size);
+    }
+
+    // 位反转序
+    int levels = 0;
+    while ((1 << levels) < half) levels++;
+    for (int i = 0; i < half; i++) {
+        int r = 0;
+        for (int b = 0; b < levels; b++) r |= ((i >> b) & 1) << (levels - 1 - b);
+        welch->reverse[i] = r;
+    }
+
+    return 0;
+}
+
+// 流式输入：环形缓冲每积累半段即处理一段
+void Welch_Process(Welch_State *welch, double *audio, uint32_t count) {
+    int hop = welch->size / 2;
+    for (uint32_t i = 0; i < count; i++) {
+        welch->ring[welch->fill++] = audio[i];
+        if (welch->fill == welch->size) {
+            Welch_Segment(welch);
+            memmove(welch->ring, welch->ring + hop, hop * sizeof(double));
+            welch->fill = hop;
+        }
+    }
+}
+
+// 处理一段：偶、奇采样打包为 size/2 点复数序列做 FFT，再拆分出实数序列的频谱
+void Welch_Segment(Welch_State *welch) {
+    int size = welch->size, half = size / 2;
+    double *z = welch->work, *w = welch->twiddle;
+
+    for (int n = 0; n < half; n++) {
+        int r = welch->reverse[n];
+        z[2 * r] = welch->ring[2 * n] * welch->window[2 * n];
+        z[2 * r + 1] = welch->ring[2 * n + 1] * welch->window[2 * n + 1];
+    }
+    FFT_Complex(welch, z);
+
+    // X[k] = E[k] + W^k·O[k]，E、O 由 Z[k] 与 conj(Z[half-k]) 求出；单边谱除直流与奈奎斯特外乘 2
+    for (int k = 0; k <= half; k++) {
+        int a = k % half, b = (half - k) % half;
+        double zr = z[2 * a], zi = z[2 * a + 1];
+        double cr = z[2 * b], ci = -z[2 * b + 1];
+        double er = (zr + cr) / 2, ei = (zi + ci) / 2;
+        double or = (zi - ci) / 2, oi = -(zr - cr) / 2;
+        double wr = k < half ? w[2 * k] : -1, wi = k < half ? w[2 * k + 1] : 0;
+        double xr = er + wr * or - wi * oi;
+        double xi = ei + wr * oi + wi * or;
+        double power = (xr * xr + xi * xi) * welch->scale;
+        welch->psd[k] += (k == 0 || k == half) ? power : 2 * power;
+    }
+    welch->segments++;
+}
+
+// 原位基 2 复数 FFT，输入已按位反转序排列；size/2 点 FFT 的旋转因子为 twiddle 的偶数项
+void FFT_Complex(Welch_State *welch, double *z) {
+    int half = welch->size / 2;
+    double *w = welch->twiddle;
+
+    for (int span = 1; span < half; span <<= 1) {
+        int stride = half / span;
+        for (int start = 0; start < half; start += 2 * span) {
+            for (int j = 0; j < span; j++) {
+                double wr = w[2 * j * stride], wi = w[2 * j * stride + 1];
+                double *p = z + 2 * (start + j), *q = z + 2 * (start + j + span);
+                double tr = q[0] * wr - q[1] * wi;
+                double ti = q[0] * wi + q[1] * wr;
+                q[0] = p[0] - tr;
+                q[1] = p[1] - ti;
+                p[0] += tr;
+                p[1] += ti;
+            }
+        }
+    }
+}
+
+// 释放 Welch 估计
+void Welch_Free(Welch_State *welch) {
+    free(welch->window);
+    free(welch->ring);
+    free(welch->psd);
+    free(welch->twiddle);
+    free(welch->work);
+    free(welch->reverse);
+    memset(welch, 0, sizeof(Welch_State));
+}
+
+// [low, high) 内各频点的功率之和
+double Band_Power(double *psd, int bins, double resolution, double low, double high) {
+    double sum = 0;
+    for (int k = 0; k < bins; k++) {
+        double f = k * resolution;
+        if (f >= low && f < high) sum += psd[k];
+    }
+
+    return sum;
+}
+
+// 功率谱密度不低于门限的最低与最高频率
+void Occupied_Bandwidth(double *psd, int bins, double resolution, double threshold, double *low, double *high) {
+    int lo = 0, hi = bins - 1;
+    while (lo < bins - 1 && psd[lo] < threshold) lo++;
+    while (hi > 0 && psd[hi] < threshold) hi--;
+    *low = lo * resolution;
+    *high = hi * resolution;
+}
+
+// 单调时钟 (秒)
+double Spectrum_Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,98 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 13: Hot-path instrumentation and statistics report
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "header.h"
+
+// 获取外部变量
+extern uint32_t sample_rate;
+
+// 定义程序内全局变量
+SSTV_Stats stats;             // 性能计数
+int stats_enabled;            // 是否记录性能计数
+
+// 声明程序内函数
+uint64_t Stats_Cycles();
+double Stats_Wall();
+void Stats_Start();
+void Stats_Report(int);
+
+// 读取周期计数：x86 使用 TSC，开销约数纳秒；其他平台退化为单调时钟的纳秒数
+uint64_t Stats_Cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// 单调时钟 (秒)
+double Stats_Wall() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 开始计数
+void Stats_Start() {
+    memset(&stats, 0, sizeof(SSTV_Stats));
+    stats.start_cycles = Stats_Cycles();
+    stats.start_wall = Stats_Wall();
+}
+
+// 打印统计：各阶段周期数按全程的周期与时间之比折算为时间
+void Stats_Report(int json) {
+    static const char *names[STAGE_COUNT] = {"load", "pixel", "synth", "output"};
+    static const char *labels[STAGE_COUNT] = {"图像加载", "像素取值", "波形合成", "量化写出"};
+
+    double wall = Stats_Wall() - stats.start_wall;
+    uint64_t cycles = Stats_Cycles() - stats.start_cycles;
+    double per_second = wall > 0 ? cycles / wall : 0;
+    double stage_wall[STAGE_COUNT], other = wall;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        stage_wall[i] = per_second > 0 ? stats.cycles[i] / per_second : 0;
+        other -= stage_wall[i];
+    }
+
+    if (json) {
+        printf("{\"wall_s\": %.6f, \"cycles\": %llu, \"stages\": {", wall, (unsigned long long)cycles);
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            printf("%s\"%s\": {\"cycles\": %llu, \"wall_s\": %.6f, \"calls\": %llu}", i ? ", " : "", names[i],
+                   (unsigned long long)stats.cycles[i], stage_wall[i], (unsigned long long)stats.calls[i]);
+        }
+        printf("}, \"tones\": %llu, \"samples\": %llu, \"bytes\": %llu, \"realtime\": %.2f}\n",
+               (unsigned long long)stats.tones, (unsigned long long)stats.samples, (unsigned long long)stats.bytes,
+               wall > 0 ? stats.samples / (double)sample_rate / wall : 0);
+        return;
+    }
+
+    printf("性能统计: 总耗时 %.3f 秒，%llu 个周期\n", wall, (unsigned long long)cycles);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        printf("  %s  %8.3f 秒  %5.1f%%  %12llu 周期  %10llu 次\n", labels[i], stage_wall[i],
+               wall > 0 ? 100 * stage_wall[i] / wall : 0, (unsigned long long)stats.cycles[i], (unsigned long long)stats.calls[i]);
+    }
+    printf("  其他      %8.3f 秒  %5.1f%%\n", other, wall > 0 ? 100 * other / wall : 0);
+    printf("音调 %llu 个，采样 %llu 个 (%.1f 倍实时)，写出 %llu 字节\n", (unsigned long long)stats.tones,
+           (unsigned long long)stats.samples, wall > 0 ? stats.samples / (double)sample_rate / wall : 0,
+           (unsigned long long)stats.bytes);
+}
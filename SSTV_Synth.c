@@ -0,0 +1,238 @@
+/*
+This C program modulates audio for SSTV (Slow-Scan Television) transmission.
+It serves as a reference for developing future image transmission protocols onboard HyacinthSat.
+
+Part 20: Selectable tone synthesis backends
+Version: 0.0.3    Date: October 18, 2026
+
+Developer & Acknowledgments:
+    BG7ZDQ - Initial implementation
+    BI4PYM - Protocol refinements and code improvements
+    N7CXI  - Reference: "Proposal for SSTV Mode Specifications"
+
+License: MIT License
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+
+// 定义程序内全局常量
+#define SYNTH_BLOCK 64                     // 查表合成的块长度 (采样)，覆盖各模式的单个像素
+#define SYNTH_LEVELS 511                   // 像素取值的级数：0~255 及 PD 模式色度均值的半级
+#define BUCKET_BITS 12                     // 起始相位查表的位数
+#define BUCKET_COUNT (1 << BUCKET_BITS)    // 起始相位查表的桶数
+#define ROTATOR_LANES 4                    // 旋转振荡器的交织路数，各路互不依赖，可向量化
+
+// 获取外部变量
+extern uint32_t sample_rate;
+
+// 结构体：一个像素取值对应的音调块，以零相位起始
+typedef struct {
+    double frequency;         // 频率，与调制函数中的表达式逐位相同
+    uint64_t step;            // 每采样相位增量
+    double sin_part[SYNTH_BLOCK]; // sin(增量×i)
+    double cos_part[SYNTH_BLOCK]; // cos(增量×i)
+} Synth_Entry;
+
+// 定义程序内全局变量
+int synth_backend = SYNTH_LIBM; // 合成后端
+Synth_Entry *synth_table;     // 各像素取值的音调块
+double bucket_sin[BUCKET_COUNT], bucket_cos[BUCKET_COUNT]; // 各相位桶起点的正弦与余弦
+uint32_t synth_rate;          // 建表时的采样率
+int bucket_ready;             // 相位桶是否已建立
+
+// 声明程序内函数
+int Synth_Backend(char *);
+const char *Synth_Name(int);
+int Synth_Init();
+void Synth_Buckets();
+void Synth_Free();
+Synth_Entry *Synth_Lookup(double);
+uint64_t Synth_Step(double);
+void Synth_Phase(uint64_t, double *, double *);
+void Synth_Tone(double *, double, uint64_t, uint64_t, uint32_t, uint32_t);
+double Synth_Fade(uint32_t);
+void Synth_Rotate(double *, double *, uint64_t, uint64_t, uint32_t, uint32_t);
+
+// 由名称取得合成后端，未知时返回 -1
+int Synth_Backend(char *name) {
+    if (strcmp(name, "libm") == 0) return SYNTH_LIBM;
+    if (strcmp(name, "lut") == 0) return SYNTH_LUT;
+    if (strcmp(name, "rotator") == 0) return SYNTH_ROTATOR;
+    return -1;
+}
+
+// 合成后端的名称
+const char *Synth_Name(int backend) {
+    return backend == SYNTH_LUT ? "lut" : backend == SYNTH_ROTATOR ? "rotator" : "libm";
+}
+
+// 建表：起始相位的分桶正弦、余弦，查表后端另按当前采样率求出每个像素取值的相位增量与一块零相位起始的正弦、余弦。
+// 须在启动合成线程之前调用，之后表只读
+int Synth_Init() {
+    if (synth_backend != SYNTH_LIBM) Synth_Buckets();
+    if (synth_backend != SYNTH_LUT || synth_rate == sample_rate) return 0;
+
+    if (!synth_table) synth_table = malloc(SYNTH_LEVELS * sizeof(Synth_Entry));
+    if (!synth_table) {
+        printf("合成查找表内存分配失败。\n");
+        return -1;
+    }
+    for (int k = 0; k < SYNTH_LEVELS; k++) {
+        Synth_Entry *entry = &synth_table[k];
+        entry->frequency = 1500 + (k * 0.5) * COLOR_FREQ_MULT;
+        entry->step = Phase_Step(entry->frequency);
+        for (int i = 0; i < SYNTH_BLOCK; i++) {
+            double radians = (int64_t)(entry->step * i) * PHASE_UNIT;
+            entry->sin_part[i] = sin(radians);
+            entry->cos_part[i] = cos(radians);
+        }
+    }
+    synth_rate = sample_rate;
+
+    return 0;
+}
+
+// 建立相位桶，查表后端、旋转振荡器与增量编码的复用段使用；与采样率无关，只建一次
+void Synth_Buckets() {
+    if (bucket_ready) return;
+    for (int b = 0; b < BUCKET_COUNT; b++) {
+        double radians = (int64_t)((uint64_t)b << (64 - BUCKET_BITS)) * PHASE_UNIT;
+        bucket_sin[b] = sin(radians);
+        bucket_cos[b] = cos(radians);
+    }
+    bucket_ready = 1;
+}
+
+// 释放查找表
+void Synth_Free() {
+    free(synth_table);
+    synth_table = NULL;
+    synth_rate = 0;
+}
+
+// 频率对应的表项：频率须与 1500 + 取值×COLOR_FREQ_MULT 逐位相同，否则返回空
+Synth_Entry *Synth_Lookup(double frequency) {
+    if (!synth_table) return NULL;
+    double level = (frequency - 1500) * (2 / COLOR_FREQ_MULT);
+    if (level < -0.5 || level > SYNTH_LEVELS - 0.5) return NULL;
+    Synth_Entry *entry = &synth_table[(int)(level + 0.5)];
+
+    return entry->frequency == frequency ? entry : NULL;
+}
+
+// 每采样相位增量：像素取值查表，其余频率照常计算，两者结果相同
+uint64_t Synth_Step(double frequency) {
+    Synth_Entry *entry = Synth_Lookup(frequency);
+    return entry ? entry->step : Phase_Step(frequency);
+}
+
+// 任意定点相位的正弦与余弦：高位查桶，余下不足一桶的角度 δ 以泰勒级数旋转
+void Synth_Phase(uint64_t phase, double *s, double *c) {
+    uint32_t b = phase >> (64 - BUCKET_BITS);
+    double delta = (phase & ((1ULL << (64 - BUCKET_BITS)) - 1)) * PHASE_UNIT;
+    double d2 = delta * delta;
+    double sin_d = delta * (1 - d2 / 6 * (1 - d2 / 20));
+    double cos_d = 1 - d2 / 2 * (1 - d2 / 12 * (1 - d2 / 30));
+
+    *s = bucket_sin[b] * cos_d + bucket_cos[b] * sin_d;
+    *c = bucket_cos[b] * cos_d - bucket_sin[b] * sin_d;
+}
+
+// 生成一个音调的第 [first, last) 个采样，phase 为该音调的起始相位。
+// 查表后端从音调起点起每 SYNTH_BLOCK 个采样为一块，块起点的相位精确计算，块内为查表与一次复数乘法；
+// 分块只取决于采样在音调内的位置，分段生成与一次生成的结果逐位相同
+void Synth_Tone(double *out, double frequency, uint64_t step, uint64_t phase, uint32_t first, uint32_t last) {
+    if (frequency == 0) {
+        double level = sin((int64_t)phase * PHASE_UNIT);
+        for (uint32_t i = first; i < last; i++) *out++ = level * Synth_Fade(i);
+        return;
+    }
+    if (synth_backend == SYNTH_ROTATOR) {
+        Synth_Rotate(out, NULL, step, phase, first, last);
+        return;
+    }
+    Synth_Entry *entry = synth_backend == SYNTH_LUT ? Synth_Lookup(frequency) : NULL;
+
+    if (!entry) {
+        for (uint32_t i = first; i < last; i++) {
+            *out++ = sin((int64_t)(phase + step * i) * PHASE_UNIT);
+        }
+        return;
+    }
+
+    for (uint32_t i = first; i < last; ) {
+        uint32_t base = i - i % SYNTH_BLOCK;
+        uint32_t end = base + SYNTH_BLOCK < last ? base + SYNTH_BLOCK : last;
+        double s, c;
+        Synth_Phase(phase + step * base, &s, &c);
+        for (; i < end; i++) {
+            *out++ = entry->sin_part[i - base] * c + entry->cos_part[i - base] * s;
+        }
+    }
+}
+
+// 频率为 0 的静默段第 i 个采样的幅度：相位保持不变，开头 SILENCE_FADE_MS 内由上一音调的末值按升余弦衰减到零，
+// 之后为真正的零，不输出直流；各后端与缓存块、复基带、混合输出均以此为准
+double Synth_Fade(uint32_t i) {
+    uint32_t length = sample_rate * SILENCE_FADE_MS / 1000;
+    if (i >= length) return 0;
+
+    return 0.5 * (1 + cos(PI * (i + 1) / length));
+}
+
+// 旋转振荡器：z(i+1) = z(i)·e^(jθ)，每个采样一次复数乘法。ROTATOR_LANES 路交织，第 j 路生成第 j, j+L, j+2L... 个采样，
+// 每路乘以 e^(jLθ)，各路互不依赖。递推的幅度与相位误差逐步累积，因此在音调起点及其后每 SYNTH_BLOCK 个采样
+// 由定点相位重新求出各路初值（重新归一化），误差不跨块累积；块内先完整生成再截取，分段生成的结果逐位相同。
+// cos_out 非空时同时写出余弦分量，供增量编码保存正交分量
+void Synth_Rotate(double *out, double *cos_out, uint64_t step, uint64_t phase, uint32_t first, uint32_t last) {
+    // 各路相对第 0 路的相位 e^(jkθ) 与每路的旋转量 e^(jLθ)，由 e^(jθ) 连乘得到
+    double lane_sin[ROTATOR_LANES], lane_cos[ROTATOR_LANES], step_sin, step_cos;
+    Synth_Phase(step, &step_sin, &step_cos);
+    lane_sin[0] = 0;
+    lane_cos[0] = 1;
+    for (int j = 1; j < ROTATOR_LANES; j++) {
+        lane_sin[j] = lane_sin[j - 1] * step_cos + lane_cos[j - 1] * step_sin;
+        lane_cos[j] = lane_cos[j - 1] * step_cos - lane_sin[j - 1] * step_sin;
+    }
+    double turn_sin = lane_sin[ROTATOR_LANES - 1] * step_cos + lane_cos[ROTATOR_LANES - 1] * step_sin;
+    double turn_cos = lane_cos[ROTATOR_LANES - 1] * step_cos - lane_sin[ROTATOR_LANES - 1] * step_sin;
+
+    for (uint32_t i = first; i < last; ) {
+        uint32_t base = i - i % SYNTH_BLOCK;
+        uint32_t end = base + SYNTH_BLOCK < last ? base + SYNTH_BLOCK : last;
+        double s, c, z_sin[ROTATOR_LANES], z_cos[ROTATOR_LANES], block[SYNTH_BLOCK], block_cos[SYNTH_BLOCK];
+        Synth_Phase(phase + step * base, &s, &c);
+        for (int j = 0; j < ROTATOR_LANES; j++) {
+            z_sin[j] = s * lane_cos[j] + c * lane_sin[j];
+            z_cos[j] = c * lane_cos[j] - s * lane_sin[j];
+        }
+        // 整块落在所求区间内时直接写入输出，否则先写入块缓冲再截取
+        int direct = i == base && (end - base) % ROTATOR_LANES == 0;
+        double *target = direct ? out : block;
+        double *target_cos = direct && cos_out ? cos_out : block_cos;
+        for (uint32_t m = 0; m < end - base; m += ROTATOR_LANES) {
+            for (int j = 0; j < ROTATOR_LANES; j++) {
+                double next_sin = z_sin[j] * turn_cos + z_cos[j] * turn_sin;
+                double next_cos = z_cos[j] * turn_cos - z_sin[j] * turn_sin;
+                target[m + j] = z_sin[j];
+                target_cos[m + j] = z_cos[j];
+                z_sin[j] = next_sin;
+                z_cos[j] = next_cos;
+            }
+        }
+        if (direct) {
+            out += end - base;
+            if (cos_out) cos_out += end - base;
+            i = end;
+        }
+        for (; i < end; i++) {
+            *out++ = block[i - base];
+            if (cos_out) *cos_out++ = block_cos[i - base];
+        }
+    }
+}
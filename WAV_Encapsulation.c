@@ -18,34 +18,80 @@ License: MIT License
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include "header.h"
 
-// 定义全局常量
-#define SAMPLE_RATE 44100                  // WAV文件采样率
-#define PI 3.14159265358979323846          // 圆周率
+// 定义程序内全局常量
+#define BLOCK_SAMPLES 4096                 // 每次写出的采样块长度
 
 // 获取外部变量
 extern char *filename;
+extern int iq_format;
+extern double iq_offset;
+extern double fm_deviation;
 
 // 定义程序内全局变量
 FILE *file;                   // 容器的文件指针
-uint32_t total_samples;       // 总采样数
-double olderdata;             // 前一个幅度，用于连续相位
-double oldercos;              // 前一个COS，用于连续相位
-double delta_lenth = 0;       // 采样率精度补偿
+uint32_t sample_rate = SAMPLE_RATE; // 合成采样率
+uint64_t total_samples;       // 总采样数
+int sample_format = WAV_PCM16; // WAV 采样格式
+int force_rf64;               // 始终以 RF64 格式写出
+uint64_t phase_acc;           // 相位累加器 (定点，2^-64 周)，用于连续相位
+uint64_t time_ns;             // 当前时间轴位置 (纳秒)
+uint64_t timeline_samples;    // 时间轴上已分配的采样数
+PCM_Block *recording;         // 正在录制的缓存块，非空时 WAV_Write 写入缓存而非文件
+uint64_t saved_phase;         // 录制前的相位
+uint64_t saved_time, saved_timeline; // 录制前的时间轴状态
+Tone_List *capture;           // 正在记录的音调时序表，非空时 WAV_Write 只记录时序不生成波形
+uint64_t capture_time, capture_timeline; // 记录前的时间轴状态
+int mmap_io;                  // 以内存映射方式读入图像、写出 WAV
+uint64_t planned_samples;     // 预计的总采样数，非零时按此预分配并映射输出文件
+uint8_t *mapped;              // 输出文件的映射区，非空时采样直接写入映射区
+size_t mapped_size;           // 映射区大小
+int write_failed;             // 写出失败后为 1，之后的采样全部拒绝，关闭时返回错误
 
 // 声明程序内函数
-int Write_WAV_Header(uint32_t);
+int Write_WAV_Header(uint64_t, int);
+int Sample_Bytes();
 int WAV_Initialization();
-int sign(double);
+int WAV_Open();
+int WAV_Map();
+int WAV_Close();
+uint64_t Sample_At(uint64_t);
+uint64_t Duration_NS(double);
+uint64_t Phase_Step(double);
 int WAV_Write(double, double);
+int WAV_Block_Begin(PCM_Block *);
+int WAV_Block_End();
+int WAV_Write_Block(PCM_Block *);
+uint64_t Block_Position(uint64_t);
+void WAV_Block_Free(PCM_Block *);
+int WAV_Write_Audio(double *, uint32_t);
+int WAV_Output(double *, uint32_t);
+int WAV_Capture_Begin(Tone_List *);
+int WAV_Capture_End();
+int WAV_Capture_Continue(Tone_List *);
+int WAV_Capture_Keep();
+int WAV_Line();
+int Tone_Append(Tone_List *, double, uint32_t);
+void Tone_Free(Tone_List *);
+int Tone_Same(Tone_List *, Tone_List *);
 int WAV_Finalization();
 
 // 结构体：用于存储 WAV 文件格式的头部信息
-typedef struct {
+// 固定预留 ds64 块的位置：数据不超过 4 GiB 时该块写作 JUNK，超过或指定 --rf64 时改写为 ds64 并将 RIFF 改为 RF64
+typedef struct __attribute__((packed)) {
     char riff[4];
     uint32_t chunk_size;
     char wave[4];
+    char ds64[4];
+    uint32_t ds64_size;
+    uint64_t riff_size_64;
+    uint64_t data_size_64;
+    uint64_t sample_count_64;
+    uint32_t table_length;
     char fmt[4];
     uint32_t subchunk1_size;
     uint16_t audio_format;
@@ -54,88 +100,489 @@ typedef struct {
     uint32_t byte_rate;
     uint16_t block_align;
     uint16_t bits_per_sample;
+    uint16_t extension_size;
+    char fact[4];
+    uint32_t fact_size;
+    uint32_t sample_length;
     char data[4];
     uint32_t subchunk2_size;
 } WAVHeader;
 
-// 写入 WAV 文件头
-int Write_WAV_Header(uint32_t data_size) {
+// 写入 WAV 文件头；尺寸未知时（写入过程中）填入最大值，即使程序中断，读取端也会读到文件末尾
+int Write_WAV_Header(uint64_t data_size, int final) {
+    int bytes = Sample_Bytes();
+    uint64_t riff_size = sizeof(WAVHeader) - 8 + data_size;
+    int rf64 = force_rf64 || riff_size > UINT32_MAX;
     WAVHeader header = {
         .riff = "RIFF",
-        .chunk_size = 36 + data_size,
+        .chunk_size = !final || rf64 ? UINT32_MAX : (uint32_t)riff_size,
         .wave = "WAVE",
+        .ds64 = "JUNK",
+        .ds64_size = 28,
         .fmt = "fmt ",
-        .subchunk1_size = 16,
-        .audio_format = 1,
+        .subchunk1_size = 18,
+        .audio_format = sample_format == WAV_FLOAT32 ? 3 : 1,
         .num_channels = 1,
-        .sample_rate = SAMPLE_RATE,
-        .byte_rate = SAMPLE_RATE * 1 * 16 / 8,
-        .block_align = 1 * 16 / 8,
-        .bits_per_sample = 16,
+        .sample_rate = sample_rate,
+        .byte_rate = sample_rate * 1 * bytes,
+        .block_align = 1 * bytes,
+        .bits_per_sample = 8 * bytes,
+        .extension_size = 0,
+        .fact = "fact",
+        .fact_size = 4,
+        .sample_length = !final || rf64 ? UINT32_MAX : (uint32_t)(data_size / bytes),
         .data = "data",
-        .subchunk2_size = data_size
+        .subchunk2_size = !final || rf64 ? UINT32_MAX : (uint32_t)data_size
     };
+    if (final && rf64) {
+        memcpy(header.riff, "RF64", 4);
+        memcpy(header.ds64, "ds64", 4);
+        header.riff_size_64 = riff_size;
+        header.data_size_64 = data_size;
+        header.sample_count_64 = data_size / bytes;
+    }
+    if (mapped) {
+        memcpy(mapped, &header, sizeof(WAVHeader));
+        return 0;
+    }
     fseek(file, 0, SEEK_SET);
     fwrite(&header, sizeof(WAVHeader), 1, file);
+
+    return 0;
+}
+
+// 每个采样占用的字节数
+int Sample_Bytes() {
+    return sample_format == WAV_PCM24 ? 3 : sample_format == WAV_FLOAT32 ? 4 : 2;
 }
 
-// 文件初始化，创建文件并写入文件头
+// 文件初始化，创建文件并写入文件头，随后写入前导静音
 int WAV_Initialization() {
+    if (WAV_Open() != 0) return -1;
+    WAV_Write(0, LEAD_SILENCE_MS);
+
+    return 0;
+}
+
+// 创建文件并写入文件头
+int WAV_Open() {
     total_samples = 0;
-    file = fopen(filename, "wb");
+    write_failed = 0;
+    time_ns = 0;
+    phase_acc = 0;
+    timeline_samples = 0;
+    file = fopen(filename, mmap_io ? "wb+" : "wb");
     if (!file) {
         printf("无法打开文件");
         return -1;
     }
-    Write_WAV_Header(0);
-    WAV_Write(0, 200);
+    int status = 0;
+    if (sample_format == WAV_FLAC && !iq_format) {
+        status = FLAC_Initialization();
+    } else if (!iq_format && mmap_io && planned_samples > 0) {
+        status = WAV_Map();
+    } else if (!iq_format) {
+        Write_WAV_Header(0, 0);
+    }
 
-    return 0;
+    // 容器初始化失败时关闭文件，调用者不再调用 WAV_Close
+    if (status != 0) {
+        fclose(file);
+        file = NULL;
+    }
+
+    return status;
 }
 
-// 判断正负号
-int sign(double num) {
-    if (num >= 0) {
-        return 1;
-    } else if (num < 0) {
+// 按预计的总采样数预分配输出文件并映射，文件头直接写入最终长度，收尾时无需回写
+int WAV_Map() {
+    mapped_size = sizeof(WAVHeader) + planned_samples * Sample_Bytes();
+    if (ftruncate(fileno(file), mapped_size) != 0) {
+        printf("输出文件预分配失败。\n");
+        return -1;
+    }
+    mapped = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+    if (mapped == MAP_FAILED) {
+        mapped = NULL;
+        printf("输出文件映射失败。\n");
         return -1;
-    } else {
-        return 0;
     }
+    Write_WAV_Header(planned_samples * Sample_Bytes(), 1);
+
+    return 0;
 }
 
-// Todo: 拓展为频率、开始时间、持续时长、相位四个参数，以实现在同一时间存入多种频率分量和对相位调制的支持
+// 时间轴上 t 纳秒处对应的采样序号，向下取整；音调边界按累计时间计算，不累积舍入误差
+uint64_t Sample_At(uint64_t t_ns) {
+    return t_ns / 1000000000 * sample_rate + t_ns % 1000000000 * sample_rate / 1000000000;
+}
+
+// 毫秒时长换算为整数纳秒，各模式的时长均为整数纳秒
+uint64_t Duration_NS(double duration_ms) {
+    return (uint64_t)llround(duration_ms * 1e6);
+}
+
+// 频率对应的每采样相位增量，定点表示，单位 2^-64 周
+// 相位以整数累加，按 2^64 自然回绕；音调的相位推进为 增量×采样数，任意顺序求和结果都完全相同
+uint64_t Phase_Step(double frequency) {
+    double turns = frequency / sample_rate;
+    turns -= floor(turns + 0.5);
+    return (uint64_t)llround(turns * 18446744073709551616.0);
+}
+
+// 多个频率分量的同时发送由 SSTV_Mixer.c 实现：先以 WAV_Capture_Begin 记录各载波的音调时序，
+// 再按各自的频率偏移、起始时间与初始相位合成
 
 // 生成并向WAV容器写入指定频率和持续时间的正弦波
 int WAV_Write(double frequency, double duration_ms) {
-    uint32_t num_samples = SAMPLE_RATE * duration_ms / 1000;
-    delta_lenth += SAMPLE_RATE * duration_ms / 1000 - num_samples;
-    if (delta_lenth >= 1) {
-        num_samples += (int)delta_lenth;
-        delta_lenth -= (int)delta_lenth;
-    }
-    double phi_samples = SAMPLE_RATE * (sign(oldercos) * asin(olderdata) + abs(sign(oldercos) - 1) / 2 * PI);
-    short buffer[num_samples];
-    for (uint32_t i = 0; i < num_samples; ++i) {
-        buffer[i] = (short)(32767 * sin((2 * PI * frequency * i + phi_samples) / SAMPLE_RATE));
-    }
-    fwrite(buffer, sizeof(short), num_samples, file);
-    total_samples += num_samples;
-    olderdata = sin((2 * PI * frequency * num_samples + phi_samples) / SAMPLE_RATE);
-    oldercos = cos((2 * PI * frequency * num_samples + phi_samples) / SAMPLE_RATE);
+    // 音调结束于时间轴上的精确时刻，采样数为该时刻对应的采样序号减去已分配的采样数
+    time_ns += Duration_NS(duration_ms);
+    uint64_t end = Sample_At(time_ns);
+    uint32_t num_samples = end > timeline_samples ? end - timeline_samples : 0;
+    timeline_samples += num_samples;
+
+    // 时序记录模式：只记录音调，不生成波形
+    if (capture && !recording) {
+        return Tone_Append(capture, frequency, num_samples);
+    }
+
+    // 第 i 个采样的相位为 起始相位 + 增量×i，与其他采样无关
+    uint64_t step = Synth_Step(frequency);
+    uint64_t phase = phase_acc;
+    phase_acc += step * num_samples;
+
+    // 录制模式：同时保存正弦与余弦分量，供之后以任意起始相位重放
+    if (recording) {
+        float *cos_part = realloc(recording->cos_part, (recording->num_samples + num_samples) * sizeof(float));
+        float *sin_part = realloc(recording->sin_part, (recording->num_samples + num_samples) * sizeof(float));
+        if (!cos_part || !sin_part) {
+            printf("缓存块内存分配失败。\n");
+            return -1;
+        }
+        for (uint32_t i = 0; i < num_samples; ++i) {
+            double radians = (int64_t)(phase + step * i) * PHASE_UNIT;
+            double gain = frequency == 0 ? Synth_Fade(i) : 1;
+            cos_part[recording->num_samples + i] = (float)(cos(radians) * gain);
+            sin_part[recording->num_samples + i] = (float)(sin(radians) * gain);
+        }
+        recording->cos_part = cos_part;
+        recording->sin_part = sin_part;
+        recording->num_samples += num_samples;
+        Tone_Append(&recording->tones, frequency, num_samples);
+        return 0;
+    }
+
+    // 复基带输出：由同一相位直接生成解析信号；调频输出则先生成音频再交给调频级
+    STATS_ADD(tones, 1);
+    if (iq_format && fm_deviation == 0) {
+        STATS_BEGIN(t);
+        IQ_Write(frequency, (int64_t)phase * PHASE_UNIT, num_samples);
+        STATS_END(STAGE_SYNTH, t);
+        STATS_ADD(samples, num_samples);
+        total_samples += num_samples;
+    } else {
+        double buffer[BLOCK_SAMPLES];
+        for (uint32_t done = 0; done < num_samples; ) {
+            uint32_t count = num_samples - done < BLOCK_SAMPLES ? num_samples - done : BLOCK_SAMPLES;
+            STATS_BEGIN(t);
+            Synth_Tone(buffer, frequency, step, phase, done, done + count);
+            STATS_END(STAGE_SYNTH, t);
+            WAV_Write_Audio(buffer, count);
+            done += count;
+        }
+    }
 
     return 0;
 }
 
-// 收尾工作，更新数据大小并关闭文件
-int WAV_Finalization() {
+// 开始录制缓存块：保存当前相位与时间轴，并以零相位开始渲染。
+// 时间轴只保留当前时刻不足一秒的部分，块内音调边界与在当前时刻直接生成逐采样相同；
+// 边界只取决于起点的亚采样位置 Block_Position，该位置相同的时刻均可直接重放
+int WAV_Block_Begin(PCM_Block *block) {
+    memset(block, 0, sizeof(PCM_Block));
+    saved_phase = phase_acc;
+    saved_time = time_ns;
+    saved_timeline = timeline_samples;
+    phase_acc = 0;
+    time_ns = saved_time % 1000000000;
+    timeline_samples = Sample_At(time_ns);
+    recording = block;
+
+    return 0;
+}
+
+// 结束录制：记录块内的总相位旋转与时长，恢复录制前的状态
+int WAV_Block_End() {
+    recording->phase = phase_acc;
+    recording->duration_ns = time_ns - saved_time % 1000000000;
+    phase_acc = saved_phase;
+    time_ns = saved_time;
+    timeline_samples = saved_timeline;
+    recording = NULL;
+
+    return 0;
+}
+
+// 以当前相位重放缓存块：sin(θ+φ) = sin θ·cos φ + cos θ·sin φ，保持相位连续
+int WAV_Write_Block(PCM_Block *block) {
+
+    // 时序记录模式：追加块内的音调时序
+    if (capture) {
+        for (size_t i = 0; i < block->tones.count; i++) {
+            if (Tone_Append(capture, block->tones.tones[i].frequency, block->tones.tones[i].num_samples) != 0) return -1;
+        }
+        time_ns += block->duration_ns;
+        timeline_samples += block->num_samples;
+        return 0;
+    }
+
+    double sin_phi = sin((int64_t)phase_acc * PHASE_UNIT);
+    double cos_phi = cos((int64_t)phase_acc * PHASE_UNIT);
+    double buffer[BLOCK_SAMPLES];
+
+    STATS_ADD(tones, block->tones.count);
+    if (iq_format && fm_deviation == 0) {
+        STATS_BEGIN(t);
+        IQ_Write_Block(block, sin_phi, cos_phi);
+        STATS_END(STAGE_SYNTH, t);
+        STATS_ADD(samples, block->num_samples);
+        total_samples += block->num_samples;
+    } else {
+        for (uint32_t done = 0; done < block->num_samples; ) {
+            uint32_t count = block->num_samples - done < BLOCK_SAMPLES ? block->num_samples - done : BLOCK_SAMPLES;
+            STATS_BEGIN(t);
+            for (uint32_t i = 0; i < count; ++i) {
+                buffer[i] = block->sin_part[done + i] * cos_phi + block->cos_part[done + i] * sin_phi;
+            }
+            STATS_END(STAGE_SYNTH, t);
+            WAV_Write_Audio(buffer, count);
+            done += count;
+        }
+    }
+    phase_acc += block->phase;
+    time_ns += block->duration_ns;
+    timeline_samples += block->num_samples;
+
+    return 0;
+}
+
+// 时刻 t 在采样间隔内的位置，以 10^-9 采样为单位；位置相同的两个时刻之后等长音调的采样数相同
+uint64_t Block_Position(uint64_t t_ns) {
+    return t_ns % 1000000000 * sample_rate % 1000000000;
+}
+
+// 释放缓存块
+void WAV_Block_Free(PCM_Block *block) {
+    free(block->cos_part);
+    free(block->sin_part);
+    Tone_Free(&block->tones);
+    memset(block, 0, sizeof(PCM_Block));
+}
+
+// 写出一块归一化音频，并计入量化写出阶段的耗时
+int WAV_Write_Audio(double *audio, uint32_t count) {
+    STATS_BEGIN(t);
+    int status = WAV_Output(audio, count);
+    STATS_END(STAGE_OUTPUT, t);
+    STATS_ADD(samples, count);
 
-    WAV_Write(0, 200);
+    return status;
+}
+
+// FM 模式下交给调频级，否则按采样格式量化后写入 WAV 容器
+int WAV_Output(double *audio, uint32_t count) {
+
+    total_samples += count;
+    if (fm_deviation > 0) {
+        return FM_Process(audio, count);
+    }
+
+    if (sample_format == WAV_FLAC) {
+        return FLAC_Process(audio, count);
+    }
+
+    // 映射输出时直接量化到映射区，否则经栈上缓冲写出
+    int bytes = Sample_Bytes();
+    uint8_t buffer[4 * BLOCK_SAMPLES];
+    uint8_t *out = buffer;
+    if (mapped) {
+        uint64_t offset = sizeof(WAVHeader) + (total_samples - count) * bytes;
+        if (offset + (uint64_t)count * bytes > mapped_size) {
+            total_samples -= count;
+            printf("采样数超出预分配的输出文件。\n");
+            return -1;
+        }
+        out = mapped + offset;
+    }
+
+    if (sample_format == WAV_FLOAT32) {
+        for (uint32_t i = 0; i < count; ++i) {
+            float value = (float)audio[i];
+            memcpy(out + 4 * i, &value, 4);
+        }
+    } else if (sample_format == WAV_PCM24) {
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t value = (int32_t)(8388607 * audio[i]);
+            out[3 * i] = value & 0xFF;
+            out[3 * i + 1] = (value >> 8) & 0xFF;
+            out[3 * i + 2] = (value >> 16) & 0xFF;
+        }
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            short value = (short)(32767 * audio[i]);
+            memcpy(out + 2 * i, &value, 2);
+        }
+    }
+    if (write_failed) return -1;
+    if (!mapped && fwrite(buffer, bytes, count, file) != count) {
+        printf("输出文件写入失败。\n");
+        write_failed = 1;
+        return -1;
+    }
+
+    return 0;
+}
+
+// 开始记录音调时序：之后的 WAV_Write 只追加到时序表，时间轴从零开始
+int WAV_Capture_Begin(Tone_List *list) {
+    memset(list, 0, sizeof(Tone_List));
+    capture_time = time_ns;
+    capture_timeline = timeline_samples;
+    time_ns = 0;
+    timeline_samples = 0;
+    capture = list;
+
+    return 0;
+}
+
+// 结束记录音调时序，恢复记录前的时间轴
+int WAV_Capture_End() {
+    time_ns = capture_time;
+    timeline_samples = capture_timeline;
+    capture = NULL;
+
+    return 0;
+}
+
+// 开始记录音调时序但沿用当前时间轴，用于先记录、再按记录结果实际输出的场合
+int WAV_Capture_Continue(Tone_List *list) {
+    memset(list, 0, sizeof(Tone_List));
+    capture_time = time_ns;
+    capture_timeline = timeline_samples;
+    capture = list;
+
+    return 0;
+}
+
+// 结束记录并保留记录期间推进的时间轴，之后的输出从记录内容的末尾接续
+int WAV_Capture_Keep() {
+    capture = NULL;
+
+    return 0;
+}
+
+// 标记一条扫描线的开始，仅在记录音调时序时生效
+int WAV_Line() {
+    if (!capture || recording) return 0;
+    if (capture->line_count == capture->line_capacity) {
+        size_t capacity = capture->line_capacity ? capture->line_capacity * 2 : 256;
+        size_t *lines = realloc(capture->lines, capacity * sizeof(size_t));
+        if (!lines) {
+            printf("扫描线索引内存分配失败。\n");
+            return -1;
+        }
+        capture->lines = lines;
+        capture->line_capacity = capacity;
+    }
+    capture->lines[capture->line_count++] = capture->count;
+
+    return 0;
+}
+
+// 向时序表追加一个音调
+int Tone_Append(Tone_List *list, double frequency, uint32_t num_samples) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 4096;
+        Tone *tones = realloc(list->tones, capacity * sizeof(Tone));
+        if (!tones) {
+            printf("音调时序表内存分配失败。\n");
+            return -1;
+        }
+        list->tones = tones;
+        list->capacity = capacity;
+    }
+    list->tones[list->count].frequency = frequency;
+    list->tones[list->count].num_samples = num_samples;
+    list->count++;
+    list->total_samples += num_samples;
+
+    return 0;
+}
+
+// 释放时序表
+void Tone_Free(Tone_List *list) {
+    free(list->tones);
+    free(list->lines);
+    memset(list, 0, sizeof(Tone_List));
+}
+
+// 两份音调时序是否逐音调、逐扫描线完全相同
+int Tone_Same(Tone_List *a, Tone_List *b) {
+    if (a->count != b->count || a->line_count != b->line_count) return 0;
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->tones[i].frequency != b->tones[i].frequency || a->tones[i].num_samples != b->tones[i].num_samples) return 0;
+    }
+    for (size_t i = 0; i < a->line_count; i++) {
+        if (a->lines[i] != b->lines[i]) return 0;
+    }
+
+    return 1;
+}
 
-    uint32_t data_size = total_samples * sizeof(short);
-    Write_WAV_Header(data_size);
-    fclose(file);
+// 收尾工作，写入结尾静音后关闭容器
+int WAV_Finalization() {
+
+    WAV_Write(0, LEAD_SILENCE_MS);
+    if (WAV_Close() != 0) return -1;
 
     printf("End.\n");
     return 0;
-}
\ No newline at end of file
+}
+
+// 更新数据大小并关闭文件
+int WAV_Close() {
+    int status = 0;
+
+    if (fm_deviation > 0) FM_Flush();
+
+    // 复基带输出为无文件头的裸 I/Q 数据
+    if (sample_format == WAV_FLAC && !iq_format) {
+        status = FLAC_Finalization();
+    } else if (mapped) {
+        // 实际采样数与预计不符时修正文件头并截断
+        if (total_samples != planned_samples) {
+            Write_WAV_Header(total_samples * Sample_Bytes(), 1);
+        }
+        munmap(mapped, mapped_size);
+        mapped = NULL;
+        if (total_samples != planned_samples && ftruncate(fileno(file), sizeof(WAVHeader) + total_samples * Sample_Bytes()) != 0) {
+            printf("输出文件截断失败。\n");
+        }
+    } else if (!iq_format) {
+        Write_WAV_Header(total_samples * Sample_Bytes(), 1);
+    }
+#ifndef SSTV_NO_STATS
+    if (stats_enabled) {
+        fseek(file, 0, SEEK_END);
+        stats.bytes += ftell(file);
+    }
+#endif
+    if (fclose(file) != 0 && !write_failed) {
+        printf("输出文件写入失败。\n");
+        write_failed = 1;
+    }
+    if (write_failed) status = -1;
+    file = NULL;
+
+    return status;
+}
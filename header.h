@@ -17,9 +17,296 @@ License: MIT License
 #ifndef HEADER_H
 #define HEADER_H
 
+#include <stdint.h>
+
+// 定义全局常量
+#define SAMPLE_RATE 44100                  // 默认采样率
+#define PI 3.14159265358979323846          // 圆周率
+#define LEAD_SILENCE_MS 200                // 容器首尾的静音时长
+#define SILENCE_FADE_MS 2                  // 静默段开头由上一音调的末值衰减到零的时长
+#define PHASE_UNIT (2 * PI / 18446744073709551616.0) // 定点相位的单位 (2^-64 周) 换算为弧度
+#define WAV_PCM16 0                        // WAV 采样格式：16 位整数
+#define WAV_PCM24 1                        // WAV 采样格式：24 位整数
+#define WAV_FLOAT32 2                      // WAV 采样格式：32 位浮点
+#define WAV_FLAC 3                         // 输出无损压缩的 16 位 FLAC 而非 WAV
+#define PIXEL_RGB24 0                      // 像素格式：RGB 交织
+#define PIXEL_GRAY8 1                      // 像素格式：8 位灰度
+#define PIXEL_NV12 2                       // 像素格式：Y 平面 + UV 交织平面，4:2:0
+#define PIXEL_YUYV 3                       // 像素格式：YUYV 交织，4:2:2
+#define PIXEL_I420 4                       // 像素格式：Y、U、V 三平面，4:2:0
+#define IQ_CF32 1                          // I/Q 输出格式：复数 float32
+#define IQ_CS16 2                          // I/Q 输出格式：复数 int16
+#define STAGE_LOAD 0                       // 计时阶段：图像加载与解码
+#define STAGE_PIXEL 1                      // 计时阶段：像素通道取值
+#define STAGE_SYNTH 2                      // 计时阶段：波形合成
+#define STAGE_OUTPUT 3                     // 计时阶段：量化、编码与写出
+#define STAGE_COUNT 4                      // 计时阶段数
+#define COLOR_FREQ_MULT 3.1372549         // 颜色频率乘数，用于转换RGB值到频率(0-255映射到1500~2300)
+#define SYNTH_LIBM 0                       // 合成后端：逐采样调用 libm sin
+#define SYNTH_LUT 1                        // 合成后端：按像素取值查表的音调块
+#define SYNTH_ROTATOR 2                    // 合成后端：交织的复数旋转振荡器
+
+// 结构体：单个音调
+typedef struct {
+    double frequency;         // 频率
+    uint32_t num_samples;     // 采样数
+} Tone;
+
+// 结构体：音调时序表，按顺序记录一段发送内容的全部音调
+typedef struct {
+    Tone *tones;              // 音调数组
+    size_t count;             // 音调数
+    size_t capacity;          // 已分配容量
+    uint64_t total_samples;   // 总采样数
+    size_t *lines;            // 每条扫描线首个音调的序号
+    size_t line_count;        // 扫描线数
+    size_t line_capacity;     // 扫描线索引已分配容量
+} Tone_List;
+
+// 结构体：相位无关的缓存音频块，录制时以零相位起始，重放时旋转到当前相位
+typedef struct {
+    uint32_t num_samples;     // 块内采样数
+    float *cos_part;          // 余弦分量
+    float *sin_part;          // 正弦分量
+    uint64_t phase;           // 块内的总相位推进 (定点，2^-64 周)
+    uint64_t duration_ns;     // 块的时长 (纳秒)
+    Tone_List tones;          // 块内的音调时序，供时序记录模式使用
+} PCM_Block;
+
+// 结构体：整个发送内容的时序索引，可随机生成任意区间的采样
+typedef struct {
+    Tone_List tones;          // 音调时序与扫描线索引
+    uint64_t *starts;         // 每个音调的起始采样
+    uint64_t *phases;         // 每个音调的起始相位 (定点，2^-64 周)
+    uint32_t sample_rate;     // 建立索引时的采样率
+} SSTV_Index;
+
+// 扫描线时序表：LINE() 为一条扫描线的开始，TONE(频率, 纳秒) 为固定音调，SCAN(取值, 像素数, 每像素纳秒) 为一段像素扫描。
+// 取值表达式中可使用当前列 col 与本次迭代的首行 row；PX(通道, 行偏移) 为单个像素，AVG(通道, 行偏移, 行偏移) 为两行均值，第二行超出末行时取第一行。
+// 每个表由 SSTV_Kernels.c 的 KERNEL_MODE 展开为一个专用函数，并由 KERNEL_START_NS、KERNEL_LINE_NS 展开为模式表中的时长；
+// 音调顺序与频率表达式须与对应的 Generate_* 函数逐一相同，由 --verify-timing 比较两者记录的音调时序
+#define SCOTTIE_DX_START(LINE, TONE, SCAN) \
+    TONE(1200, 9000000)
+
+#define SCOTTIE_DX_ROWS(LINE, TONE, SCAN) \
+    LINE() \
+    TONE(1500, 1500000) \
+    SCAN(PX(G, 0), 320, 1080000) \
+    TONE(1500, 1500000) \
+    SCAN(PX(B, 0), 320, 1080000) \
+    TONE(1200, 9000000) \
+    TONE(1500, 1500000) \
+    SCAN(PX(R, 0), 320, 1080000)
+
+#define PD_120_START(LINE, TONE, SCAN)
+
+#define PD_120_ROWS(LINE, TONE, SCAN) \
+    LINE() \
+    TONE(1200, 20000000) \
+    TONE(1500, 2080000) \
+    SCAN(PX(Y, 0), 640, 190000) \
+    SCAN(AVG(RY, 0, 1), 640, 190000) \
+    SCAN(AVG(BY, 0, 1), 640, 190000) \
+    SCAN(PX(Y, 1), 640, 190000)
+
+#define ROBOT_36_START(LINE, TONE, SCAN)
+
+#define ROBOT_36_ROWS(LINE, TONE, SCAN) \
+    LINE() \
+    TONE(1200, 9000000) \
+    TONE(1500, 3000000) \
+    SCAN(PX(Y, 0), 320, 275000) \
+    TONE(1500, 4500000) \
+    TONE(1900, 1500000) \
+    SCAN(AVG(RY, 0, 1), 320, 137500) \
+    LINE() \
+    TONE(1200, 9000000) \
+    TONE(1500, 3000000) \
+    SCAN(PX(Y, 1), 320, 275000) \
+    TONE(2300, 4500000) \
+    TONE(1900, 1500000) \
+    SCAN(AVG(BY, 1, 2), 320, 137500)
+
+// 时序表的时长展开：首行前的时长，以及一次迭代的时长除以其中的扫描线数
+#define KERNEL_NS_LINE()
+#define KERNEL_NS_TONE(frequency, ns) + (ns)
+#define KERNEL_NS_SCAN(value, count, ns) + (count) * (ns)
+#define KERNEL_COUNT_LINE() + 1
+#define KERNEL_COUNT_TONE(frequency, ns)
+#define KERNEL_COUNT_SCAN(value, count, ns)
+#define KERNEL_START_NS(prefix) (0ULL prefix##_START(KERNEL_NS_LINE, KERNEL_NS_TONE, KERNEL_NS_SCAN))
+#define KERNEL_LINE_NS(prefix) ((0ULL prefix##_ROWS(KERNEL_NS_LINE, KERNEL_NS_TONE, KERNEL_NS_SCAN)) \
+                                / (0 prefix##_ROWS(KERNEL_COUNT_LINE, KERNEL_COUNT_TONE, KERNEL_COUNT_SCAN)))
+
+// 结构体：调制模式的参数与时序，时长均为整数纳秒
+typedef struct {
+    char *name;               // 模式名
+    char *vis;                // VIS 码
+    int (*generate)();        // 图像数据生成函数（通用路径）
+    int (*kernel)();          // 由时序表展开的专用函数
+    int width;                // 水平分辨率
+    int height;               // 垂直分辨率
+    int lines;                // 扫描线数（PD 模式两行为一条）
+    uint64_t start_ns;        // 首条扫描线前的附加时长
+    uint64_t line_ns;         // 每条扫描线的时长
+    int quality;              // 画质等级，越大画质越好
+} SSTV_Mode;
+
+// 结构体：一次发送的规划，时刻均为整个流时间轴上的纳秒
+typedef struct {
+    const SSTV_Mode *mode;    // 调制模式
+    uint32_t sample_rate;     // 规划时的采样率
+    uint64_t start_ns;        // VIS 前导的起点
+    uint64_t image_ns;        // 第一条扫描线的起点
+    uint64_t trailer_ns;      // 结束段的起点
+    uint64_t end_ns;          // 发送结束的时刻
+    uint64_t start_sample;    // 起点对应的采样序号
+    uint64_t end_sample;      // 结束时刻对应的采样序号
+} SSTV_Plan;
+
+// 结构体：热路径性能计数
+typedef struct {
+    uint64_t cycles[STAGE_COUNT];   // 各阶段累计周期数（x86 为 TSC 周期，其他平台为纳秒）
+    uint64_t calls[STAGE_COUNT];    // 各阶段进入次数
+    uint64_t tones;           // 合成的音调数
+    uint64_t samples;         // 输出的采样数
+    uint64_t bytes;           // 写出的字节数
+    uint64_t start_cycles;    // 开始计数时的周期数
+    double start_wall;        // 开始计数时的时刻 (秒)
+} SSTV_Stats;
+
+// 结构体：Welch 功率谱估计的流式状态
+typedef struct {
+    int size;                 // 每段 FFT 点数
+    int fill;                 // 环形缓冲中的采样数
+    uint64_t segments;        // 已处理的段数
+    double scale;             // 窗能量归一化系数
+    double *window;           // 窗函数
+    double *ring;             // 输入缓冲
+    double *psd;              // 累计的单边功率谱，size/2+1 个频点
+    double *twiddle;          // 旋转因子
+    double *work;             // FFT 工作区
+    int *reverse;             // 位反转序
+} Welch_State;
+
+// 性能计数宏：编译时定义 SSTV_NO_STATS 可完全移除；未指定 --stats 时只多一次分支
+#ifdef SSTV_NO_STATS
+#define STATS_BEGIN(t)
+#define STATS_END(stage, t)
+#define STATS_ADD(field, n)
+#else
+#define STATS_BEGIN(t) uint64_t t = stats_enabled ? Stats_Cycles() : 0
+#define STATS_END(stage, t) do { if (stats_enabled) { stats.cycles[stage] += Stats_Cycles() - (t); stats.calls[stage]++; } } while (0)
+#define STATS_ADD(field, n) do { if (stats_enabled) stats.field += (n); } while (0)
+#endif
+extern SSTV_Stats stats;
+extern int stats_enabled;
+
 // 声明程序全局函数
 int WAV_Initialization();
 int WAV_Finalization();
+int WAV_Open();
+int WAV_Close();
+int WAV_Line();
+uint64_t Phase_Step(double);
 int WAV_Write(double, double);
+int WAV_Block_Begin(PCM_Block *);
+int WAV_Block_End();
+uint64_t Block_Position(uint64_t);
+void WAV_Block_Free(PCM_Block *);
+int WAV_Write_Block(PCM_Block *);
+int WAV_Write_Audio(double *, uint32_t);
+int WAV_Capture_Begin(Tone_List *);
+int WAV_Capture_End();
+int WAV_Capture_Continue(Tone_List *);
+int WAV_Capture_Keep();
+int Tone_Append(Tone_List *, double, uint32_t);
+void Tone_Free(Tone_List *);
+int Tone_Same(Tone_List *, Tone_List *);
+int Valid_Model(char *);
+int Valid_FSK_ID(char *);
+const SSTV_Mode *Find_Mode(char *);
+uint64_t Sample_At(uint64_t);
+uint64_t Duration_NS(double);
+int Encode_Image(char *, char *);
+int Encode_Pixels(char *);
+int Generate_End();
+int Generate_FSK_ID(char *);
+int Image_Load(char *);
+int Image_From_Buffer(unsigned char *, int, int, int, int);
+int Image_From_Planes(unsigned char *, unsigned char *, unsigned char *, int, int, int, int, int);
+void Image_Free();
+int Pixel_Format(char *);
+void Image_Hash(uint64_t *);
+int Pixel_Bytes(int);
+size_t Frame_Bytes(int, int, int);
+double YUV_Value(char *, int, int);
+int Mixer(char *);
+int IQ_Write(double, double, uint32_t);
+int IQ_Write_Block(PCM_Block *, double, double);
+int IQ_Emit(float *, uint32_t);
+int FM_Initialization();
+int FM_Process(double *, uint32_t);
+int FM_Flush();
+int Benchmark(char *);
+int FLAC_Initialization();
+int FLAC_Process(double *, uint32_t);
+int FLAC_Finalization();
+int Index_Build(SSTV_Index *, char *, char *);
+int Index_Alloc(SSTV_Index *);
+int Index_Phases(SSTV_Index *, uint64_t *);
+void Index_Sum(SSTV_Index *, size_t, size_t, uint64_t *, uint64_t *);
+uint64_t Index_Scan(SSTV_Index *, size_t, size_t, uint64_t, uint64_t);
+int Index_Render(SSTV_Index *, uint64_t, uint64_t, double *);
+uint64_t Index_Line_Start(SSTV_Index *, size_t);
+void Index_Free(SSTV_Index *);
+int Index_Output(char *, char *, uint64_t, uint64_t);
+int Plan_Mode(SSTV_Plan *, char *, uint64_t);
+uint64_t Plan_Line_Start(SSTV_Plan *, size_t);
+uint64_t Plan_Total_Samples(SSTV_Plan *);
+int Plan_Print(char *);
+int Timing_Verify(char *);
+int Stream_Images(char **, char **, int);
+int Playlist_Read(char *, char ***, char ***);
+void Playlist_Free(char **, char **, int);
+int Schedule(char *);
+uint64_t Stats_Cycles();
+int Spectrum_Main(int, char **);
+int Welch_Init(Welch_State *, int);
+void Welch_Process(Welch_State *, double *, uint32_t);
+void Welch_Free(Welch_State *);
+int Parallel_Threads();
+int Parallel_Begin();
+int Parallel_End();
+int Parallel_Phases(SSTV_Index *, uint64_t *);
+void Stats_Start();
+void Stats_Report(int);
+int Batch(char *, char *);
+int Daemon(char *);
+int Preprocessing(char *, char *);
+int Cache_Init();
+void Hash_Init(uint64_t *);
+void Hash_Update(uint64_t *, const void *, size_t);
+int Cache_Key(char *, char *);
+void Cache_Options(uint64_t *, char *);
+int Cache_Fetch(char *);
+int Cache_Store(char *);
+void Cache_Totals(char *);
+void Cache_Report();
+int Incremental_Encode(char *, char *);
+int Synth_Backend(char *);
+const char *Synth_Name(int);
+int Synth_Init();
+void Synth_Buckets();
+void Synth_Free();
+uint64_t Synth_Step(double);
+void Synth_Phase(uint64_t, double *, double *);
+void Synth_Tone(double *, double, uint64_t, uint64_t, uint32_t, uint32_t);
+double Synth_Fade(uint32_t);
+void Synth_Rotate(double *, double *, uint64_t, uint64_t, uint32_t, uint32_t);
+int Kernel_Usable();
+int Kernel_Scottie_DX();
+int Kernel_PD_120();
+int Kernel_Robot_36();
 
 #endif
\ No newline at end of file